@@ -3,30 +3,27 @@
 #ifndef API_UTILS_H
 #define API_UTILS_H
 
+#include <stddef.h>
+#include "currency_catalog.h"
 
-// Constants for URL format, API key, and buffer size
-#define URL_CONVERT "https://api.fxratesapi.com/convert?from=%s&to=%s&date=%s&amount=%.2lf&format=json" // URL format for currency conversion
-#define URL_CURRENCY "https://api.fxratesapi.com/currencies" // URL for fetching supported currencies
+
+// Constants for URL format, API key, and catalog size
+#define API_BASE_URL "https://api.fxratesapi.com" // Default base URL of the FX Rates API
+#define API_BASE_URL_ENV "TCONVERT_API_URL" // Environment variable overriding the base URL (e.g. a local stand-in server)
+#define URL_LATEST "%s/latest?base=%s&api_key=%s" // URL format for the current rates of every currency against a base
+#define URL_HISTORICAL "%s/historical?date=%s&base=%s&api_key=%s" // URL format for the rates of every currency on a past date
+#define URL_CURRENCY "%s/currencies" // URL format for fetching supported currencies (base URL first)
 #define API_KEY "fxr_live_a98558fd39e8f499913f443c3285447dd320" // API key for accessing FX Rates API
-#define RESPONSE_BUFFER_SIZE 4096 // Maximum size for response buffer
 #define MAX_CURRENCIES 200 // Maximum number of supported currencies
 
 
-// Define a global variable to store supported currency codes
-extern char** supportedCurrencies; // Pointer to store an array of supported currency codes
-extern int numberOfCurrencies; // Variable to track the count of supported currency codes, declaration only
-
-
-// Struct to store response data and its size
-struct MemoryStruct {
-    char *memory;   // Pointer to store memory data (e.g., API response)
-    size_t size;    // Size of the memory allocated for data storage
-};
+// Returns the base URL of the FX Rates API, honouring the TCONVERT_API_URL override
+const char* getApiBaseUrl();
 
-// Callback function for handling conversion API responses
-size_t writeCallbackForConversion(void* contents, size_t size, size_t nmemb, void* userp);
+// Callback function for parsing API responses with a cJSON stream parser as they arrive
+size_t writeCallbackForStream(void *ptr, size_t size, size_t nmemb, void *data);
 
-// Callback function for handling currency API responses
-size_t writeCallbackForCurrency(void *ptr, size_t size, size_t nmemb, void *data);
+// Callback function for capturing the ETag and Last-Modified response headers
+size_t headerCallbackForValidators(char *buffer, size_t size, size_t nitems, void *userdata);
 
 #endif /* API_UTILS_H */
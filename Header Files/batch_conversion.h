@@ -0,0 +1,21 @@
+// batch_conversion.h - Header file for the non-interactive batch conversion mode
+
+#ifndef BATCH_CONVERSION_H
+#define BATCH_CONVERSION_H
+
+
+// Constants for the batch input and output
+#define BATCH_OPTION "--batch" // Command-line option selecting batch mode: --batch [input] [output]
+#define BATCH_STDIO_PATH "-" // Path meaning standard input or standard output
+#define BATCH_LINE_SIZE 256 // Longest input row accepted, including the newline
+#define BATCH_FIELD_COUNT 4 // Fields per row: amount, from, to, date
+#define BATCH_WINDOW_ROWS 512 // Rows read ahead so the rates of their dates can be fetched together
+#define BATCH_DATE_TABLE_SIZE 1024 // Slots of the table finding a window's distinct dates (power of two above the window size)
+#define BATCH_OUTPUT_BUFFER_SIZE (64 * 1024) // Size of the buffer used for the result stream
+
+
+// Converts every row of 'inputPath' (CSV or TSV of amount, from, to, date) and streams the results to 'outputPath'
+// Returns EXIT_SUCCESS if every row was converted and EXIT_FAILURE otherwise
+int runBatchConversion(const char* inputPath, const char* outputPath);
+
+#endif /* BATCH_CONVERSION_H */
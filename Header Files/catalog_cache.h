@@ -0,0 +1,34 @@
+// catalog_cache.h - Header file for the on-disk currency catalog cache
+
+#ifndef CATALOG_CACHE_H
+#define CATALOG_CACHE_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "currency_catalog.h"
+
+
+// Constants for the catalog cache file and its refresh policy
+#define CATALOG_CACHE_FILE "currencies.cache" // Local file holding the cached currency catalog
+#define CATALOG_CACHE_MAGIC "TCVC" // Signature written at the start of the cache file
+#define CATALOG_CACHE_VERSION 3 // Version of the on-disk cache layout
+#define CATALOG_CACHE_TTL_SECONDS (24 * 60 * 60) // Default age (in seconds) after which the catalog is refreshed
+#define CATALOG_CACHE_TTL_ENV "TCONVERT_CATALOG_TTL" // Environment variable overriding the TTL (in seconds)
+
+
+// Reads a cached catalog from 'path' into a new catalog (NULL if there is no usable cache)
+CurrencyCatalog* loadCatalogCache(const char* path);
+
+// Writes the catalog to 'path' together with the time it was fetched
+bool saveCatalogCache(const char* path, const CurrencyCatalog* catalog);
+
+// Rewrites the fetch time of an existing cache file after a 304 revalidation
+bool touchCatalogCache(const char* path, time_t validatedAt);
+
+// Loads the catalog once at startup, falling back to the API only when no cache exists
+void initCurrencyCatalog();
+
+// Installs a finished background refresh and starts a new one once the TTL has expired
+void refreshCurrencyCatalogIfStale();
+
+#endif /* CATALOG_CACHE_H */
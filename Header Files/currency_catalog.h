@@ -0,0 +1,82 @@
+// currency_catalog.h - Header file for the currency catalog object
+
+#ifndef CURRENCY_CATALOG_H
+#define CURRENCY_CATALOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+
+// Constants for catalog storage
+#define CURRENCY_CODE_SIZE 8 // Bytes reserved per currency code, including the null terminator
+#define CURRENCY_SYMBOL_SIZE 8 // Bytes reserved per currency symbol (UTF-8), including the null terminator
+#define CURRENCY_INDEX_SIZE 32768 // Entries in the code index (three letters of 5 bits each = 15 bits)
+#define INVALID_CURRENCY_ID 0xFFFF // Returned when a code is not part of the catalog
+#define DEFAULT_MINOR_UNITS 2 // Decimal digits assumed when the API does not report them
+#define CATALOG_VALIDATOR_SIZE 128 // Bytes reserved for each HTTP cache validator, including the null terminator
+
+
+// Dense identifier of a currency: its position in the catalog
+typedef uint16_t CurrencyId;
+
+
+// HTTP cache validators of the /currencies response a catalog was built from
+// An empty string means the server did not send that validator
+typedef struct CatalogValidators {
+    char etag[CATALOG_VALIDATOR_SIZE];          // Value of the ETag response header
+    char lastModified[CATALOG_VALIDATOR_SIZE];  // Value of the Last-Modified response header
+} CatalogValidators;
+
+
+// Immutable snapshot of the supported currencies, stored as parallel arrays indexed by CurrencyId
+// The struct, its arrays and the name arena live in a single allocation sized at creation,
+// so a catalog of a given size always occupies the same amount of memory
+typedef struct CurrencyCatalog {
+    int count;                              // Number of currencies in the catalog
+    time_t fetchedAt;                       // Time at which the catalog was downloaded
+    unsigned long generation;               // Sequence number assigned when the catalog becomes active
+    CatalogValidators validators;           // Validators used to revalidate the catalog with a conditional request
+    char (*codes)[CURRENCY_CODE_SIZE];      // Packed code slots, one per currency
+    char (*symbols)[CURRENCY_SYMBOL_SIZE];  // Display symbol of each currency
+    uint8_t *minorUnits;                    // Number of decimal digits of each currency
+    uint32_t *nameOffsets;                  // Offset of each currency name inside 'nameArena'
+    char *nameArena;                        // All currency names, null-terminated, back to back
+    size_t nameArenaSize;                   // Capacity of 'nameArena' in bytes
+    size_t nameArenaUsed;                   // Bytes of 'nameArena' filled so far
+    uint16_t codeIndex[CURRENCY_INDEX_SIZE]; // Packed three-letter code -> currency ID + 1 (0 means absent)
+} CurrencyCatalog;
+
+
+// Allocates an empty catalog with room for 'count' currencies and 'nameArenaSize' bytes of names
+CurrencyCatalog* createCurrencyCatalog(int count, size_t nameArenaSize);
+
+// Fills slot 'id' of a catalog under construction; entries must be added in ID order
+bool setCatalogEntry(CurrencyCatalog* catalog, CurrencyId id, const char* code, const char* name, int minorUnits, const char* symbol);
+
+// Records slot 'id' in the packed code index (used when the arrays were filled directly)
+void indexCatalogCode(CurrencyCatalog* catalog, CurrencyId id);
+
+// Packs a three-letter uppercase code into 15 bits; returns -1 for any other code
+int packCurrencyCode(const char* code);
+
+// Looks up the ID of 'code' in 'catalog' (INVALID_CURRENCY_ID if absent)
+CurrencyId findCurrencyId(const CurrencyCatalog* catalog, const char* code);
+
+// Accessors for the per-currency data of a valid ID
+const char* getCurrencyCode(const CurrencyCatalog* catalog, CurrencyId id);
+const char* getCurrencyName(const CurrencyCatalog* catalog, CurrencyId id);
+const char* getCurrencySymbol(const CurrencyCatalog* catalog, CurrencyId id);
+int getCurrencyMinorUnits(const CurrencyCatalog* catalog, CurrencyId id);
+
+// Releases a catalog created with createCurrencyCatalog()
+void freeCurrencyCatalog(CurrencyCatalog* catalog);
+
+// Returns the catalog currently used for validation (NULL until one is installed)
+const CurrencyCatalog* getActiveCatalog();
+
+// Makes 'catalog' the active catalog and frees the previous generation
+void swapActiveCatalog(CurrencyCatalog* catalog);
+
+#endif /* CURRENCY_CATALOG_H */
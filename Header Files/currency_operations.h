@@ -3,16 +3,24 @@
 #ifndef CURRENCY_OPERATIONS_H
 #define CURRENCY_OPERATIONS_H
 
+#include "currency_catalog.h"
+
 // Function to perform currency conversion
 double convertCurrency(double amount, double exchangeRate);
 
+// Function to download supported currencies into a new catalog, conditionally if validators are given
+CurrencyCatalog* downloadCurrencyCatalog(const CatalogValidators* previous, bool* notModified);
+
+// Function to read how many catalog downloads were full and how many were answered with 304
+void getCatalogRevalidationStats(long* fullDownloads, long* notModified);
+
 // Function to fetch supported currencies
 void fetchSupportedCurrencies();
 
-// Function to fetch and display supported currencies
+// Function to display supported currencies from the active catalog
 void displaySupportedCurrencies();
 
-// Function to perform currency conversion
-void performCurrencyConversion(double amount, const char* fromCurrency, const char* toCurrency, const char* date);
+// Function to perform currency conversion between two catalog IDs
+void performCurrencyConversion(double amount, CurrencyId fromId, CurrencyId toId, const char* date);
 
 #endif /* CURRENCY_OPERATIONS_H */
@@ -4,12 +4,19 @@
 #define CURRENCY_UTILS_H
 
 #include <stdbool.h>
+#include "currency_catalog.h"
 
 
 // Checks if a currency code is valid
 bool isValidCurrency(const char* currencyCode);
 
-// Validates the currency code based on a specified type
-void validateCurrency(char* currency, const char* type);
+// Returns the dense ID of a currency code in the active catalog (INVALID_CURRENCY_ID if unknown)
+CurrencyId getCurrencyId(const char* currencyCode);
+
+// Checks if an ID refers to a currency of the active catalog
+bool isValidCurrencyId(CurrencyId id);
+
+// Prompts for a currency code of the specified type and returns its ID
+CurrencyId validateCurrency(const char* type);
 
 #endif /* CURRENCY_UTILS_H */
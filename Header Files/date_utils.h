@@ -19,6 +19,12 @@ void getCurrentDate(char* currentDate);
 // Retrieves the current date in UTC format
 void getCurrentDateUTC(char* currentDate);
 
+// Converts a YYYY-MM-DD date to the number of days since 1970-01-01
+long getDayNumber(const char* date);
+
+// Converts a number of days since 1970-01-01 back to a YYYY-MM-DD date
+void formatDayNumber(long dayNumber, char* date);
+
 // Converts a string to lowercase
 void toLowercase(char* str);
 
@@ -0,0 +1,43 @@
+// http_async.h - Header file for the asynchronous request engine
+
+#ifndef HTTP_ASYNC_H
+#define HTTP_ASYNC_H
+
+#include <stdbool.h>
+#include <curl/curl.h>
+#include "http_client.h"
+
+
+// Constants for the request queue
+#define HTTP_ASYNC_MAX_HOST_CONNECTIONS 8 // Connections opened per host when the server cannot multiplex
+#define HTTP_ASYNC_POLL_TIMEOUT_MS 1000 // Longest wait for socket activity in one poll
+
+
+// Called once for each finished request with its result and timings; the handle is released right after
+typedef void (*HttpCompletionCallback)(CURL* handle, CURLcode result, const HttpResponse* response, void* userData);
+
+// Set of requests driven together on one libcurl multi handle
+// A queue is not thread-safe: submit to it and poll it from a single thread
+typedef struct HttpRequestQueue {
+    CURLM* multi;       // libcurl multi handle running the transfers
+    int inFlight;       // Requests submitted and not yet completed
+    struct HttpPendingRequest* pending; // List of the requests in flight
+} HttpRequestQueue;
+
+
+// Creates the multi handle of a queue, with HTTP/2 multiplexing enabled
+bool initHttpRequestQueue(HttpRequestQueue* queue);
+
+// Aborts any requests still in flight and releases the queue
+void cleanupHttpRequestQueue(HttpRequestQueue* queue);
+
+// Starts the request configured on 'handle' (from acquireHttpHandle(), owned by the queue from now on)
+bool submitHttpRequest(HttpRequestQueue* queue, CURL* handle, HttpCompletionCallback callback, void* userData);
+
+// Runs transfers for up to 'timeoutMs', invokes the callbacks of finished requests and returns how many are still in flight
+int pollHttpRequests(HttpRequestQueue* queue, int timeoutMs);
+
+// Polls until every submitted request has completed
+void waitForHttpRequests(HttpRequestQueue* queue);
+
+#endif /* HTTP_ASYNC_H */
@@ -0,0 +1,45 @@
+// http_client.h - Header file for the shared HTTP transport layer
+
+#ifndef HTTP_CLIENT_H
+#define HTTP_CLIENT_H
+
+#include <stdbool.h>
+#include <curl/curl.h>
+
+
+// Constants for the handle pool
+#define HTTP_POOL_SIZE 33 // Number of long-lived easy handles kept warm for reuse (RATE_PREFETCH_CONCURRENCY plus the catalog refresh)
+#define HTTP_TRACE_ENV "TCONVERT_HTTP_TRACE" // Environment variable enabling per-request timing output
+
+
+// Outcome and timings of one request, taken from CURLINFO_*
+typedef struct HttpResponse {
+    long status;            // HTTP status code (0 if no response was received)
+    double nameLookupTime;  // Seconds until DNS resolution finished
+    double connectTime;     // Seconds until the TCP connection was established
+    double tlsTime;         // Seconds until the TLS handshake finished
+    double firstByteTime;   // Seconds until the first response byte arrived (time to first byte)
+    double totalTime;       // Seconds for the whole transfer
+    bool reusedConnection;  // True if no new connection had to be opened
+} HttpResponse;
+
+
+// Initializes libcurl and the shared DNS and TLS session caches; call once at startup
+void initHttpClient();
+
+// Releases the pooled handles and shared caches; call once before exit
+void cleanupHttpClient();
+
+// Takes a warm easy handle from the pool, reset to defaults and attached to the shared caches
+CURL* acquireHttpHandle();
+
+// Returns a handle obtained from acquireHttpHandle() to the pool, keeping its connections open
+void releaseHttpHandle(CURL* handle);
+
+// Performs the request configured on 'handle' and fills 'response' with its status and timings
+CURLcode performHttpRequest(CURL* handle, HttpResponse* response);
+
+// Fills 'response' with the status and timings of a transfer that finished with 'result'
+void collectHttpResponse(CURL* handle, CURLcode result, HttpResponse* response);
+
+#endif /* HTTP_CLIENT_H */
@@ -0,0 +1,41 @@
+// rate_engine.h - Header file for the local cross-rate engine
+
+#ifndef RATE_ENGINE_H
+#define RATE_ENGINE_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "api_utils.h"
+#include "currency_catalog.h"
+
+
+// Constants for rate vectors and their refresh window
+#define RATE_BASE_CURRENCY "USD" // Base currency every rate vector is fetched against
+#define RATE_CACHE_SLOTS 16 // Number of dates whose rate vectors are kept in memory
+#define RATES_TTL_SECONDS (60 * 60) // Default age after which the current day's rates are fetched again
+#define RATES_TTL_ENV "TCONVERT_RATES_TTL" // Environment variable overriding the rates TTL (in seconds)
+#define RATE_PREFETCH_CONCURRENCY 32 // Rate downloads kept in flight at once by prefetchRateVectors()
+
+
+// Rates of every catalog currency against the base currency for one date
+// rates[id] is the number of units of currency 'id' per unit of the base (0 when the API has no rate)
+typedef struct RateVector {
+    char date[11];                  // Date of the rates (YYYY-MM-DD)
+    time_t fetchedAt;               // Time at which the vector was downloaded
+    unsigned long catalogGeneration; // Generation of the catalog whose IDs index 'rates'
+    bool isFinal;                   // True once fetched after the day ended, so the rates can never change
+    double rates[MAX_CURRENCIES];   // Rate per currency ID
+} RateVector;
+
+
+// Returns the rate vector for 'date', downloading it only if it is not cached or has expired
+const RateVector* getRateVector(const char* date);
+
+// Downloads the rates of every date in 'dates' that is not cached yet, several at a time; returns the number downloaded
+// 'failed' may be NULL, otherwise failed[i] tells whether dates[i] is still unavailable afterwards
+int prefetchRateVectors(const char* const dates[], int count, bool failed[]);
+
+// Computes the rate from one currency to another on 'date' as rates[to] / rates[from]
+bool getCrossRate(CurrencyId fromId, CurrencyId toId, const char* date, double* rate);
+
+#endif /* RATE_ENGINE_H */
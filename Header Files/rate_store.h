@@ -0,0 +1,35 @@
+// rate_store.h - Header file for the persistent historical rate store
+
+#ifndef RATE_STORE_H
+#define RATE_STORE_H
+
+#include <stdbool.h>
+#include <time.h>
+#include "rate_engine.h"
+
+
+// Constants for the memory-mapped rate store file
+#define RATE_STORE_FILE "rates.store" // Local file holding every rate vector downloaded so far
+#define RATE_STORE_MAGIC "TCVR" // Signature written at the start of the store file
+#define RATE_STORE_VERSION 1 // Version of the on-disk store layout
+#define RATE_STORE_COLUMNS 256 // Maximum number of distinct currency codes the store can hold
+#define RATE_STORE_MAX_DAYS (200 * 366) // Number of days indexed, counted from 1970-01-01
+#define RATE_STORE_GROWTH_ROWS 64 // Number of rows added to the file each time it runs out of space
+
+
+// Maps the store at 'path', creating it if needed (the rate engine falls back to memory only on failure)
+bool openRateStore(const char* path);
+
+// Unmaps the store, flushing any rows written this session
+void closeRateStore();
+
+// Fills 'vector' with the stored rates of its date for the active catalog (false if the day is not stored)
+bool loadStoredRates(const char* date, RateVector* vector);
+
+// Reports whether the date is stored, and when and how finally its rates were fetched, without copying the rates
+bool findStoredRates(const char* date, time_t* fetchedAt, bool* isFinal);
+
+// Writes 'vector' to the row of its date, replacing a provisional row of the same day
+bool storeRates(const RateVector* vector);
+
+#endif /* RATE_STORE_H */
@@ -6,4 +6,7 @@
 // Function for clearing the input buffer
 void clearInputBuffer();
 
+// Function for reading a non-negative number of seconds from an environment variable
+long getEnvSeconds(const char* name, long defaultSeconds);
+
 #endif /* UTILITIES_H */
@@ -45,6 +45,20 @@
 #include <ctype.h>
 #include <float.h>
 
+/* Strings and whitespace are scanned 16 bytes at a time with SSE2, 32 with AVX2 when the compiler targets it.
+ * Define CJSON_NO_SIMD to keep to the portable loops. */
+#if !defined(CJSON_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2)))
+#define CJSON_SIMD_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define CJSON_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
 #ifdef ENABLE_LOCALES
 #include <locale.h>
 #endif
@@ -158,6 +172,8 @@ typedef struct internal_hooks
     void *(CJSON_CDECL *allocate)(size_t size);
     void (CJSON_CDECL *deallocate)(void *pointer);
     void *(CJSON_CDECL *reallocate)(void *pointer, size_t size);
+    cJSON_Arena *arena; /* when set, parsing allocates from this arena instead */
+    cJSON_NodePool *pool; /* when set, nodes come from and go back to this pool */
 } internal_hooks;
 
 #if defined(_MSC_VER)
@@ -183,7 +199,155 @@ static void * CJSON_CDECL internal_realloc(void *pointer, size_t size)
 /* strlen of character literals resolved at compile time */
 #define static_strlen(string_literal) (sizeof(string_literal) - sizeof(""))
 
-static internal_hooks global_hooks = { internal_malloc, internal_free, internal_realloc };
+static internal_hooks global_hooks = { internal_malloc, internal_free, internal_realloc, NULL, NULL };
+
+/* An arena block: a header followed by the memory handed out from it */
+typedef struct cJSON_ArenaBlock
+{
+    struct cJSON_ArenaBlock *next;
+    size_t size; /* usable bytes after the header */
+    size_t used;
+} cJSON_ArenaBlock;
+
+struct cJSON_Arena
+{
+    cJSON_ArenaBlock *blocks; /* the block currently allocated from comes first */
+    size_t block_size;
+};
+
+/* every allocation is rounded up to this so nodes and their doubles stay aligned */
+typedef union
+{
+    double number;
+    void *pointer;
+    size_t size;
+} arena_alignment;
+
+#define arena_align(size) ((((size) + sizeof(arena_alignment) - 1) / sizeof(arena_alignment)) * sizeof(arena_alignment))
+#define arena_block_data(block) (((unsigned char*)(block)) + arena_align(sizeof(cJSON_ArenaBlock)))
+
+static cJSON_ArenaBlock *arena_new_block(size_t size)
+{
+    cJSON_ArenaBlock *block = (cJSON_ArenaBlock*)global_hooks.allocate(arena_align(sizeof(cJSON_ArenaBlock)) + size);
+    if (block == NULL)
+    {
+        return NULL;
+    }
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+
+    return block;
+}
+
+static void *arena_allocate(cJSON_Arena * const arena, size_t size)
+{
+    cJSON_ArenaBlock *block = arena->blocks;
+    cJSON_ArenaBlock *new_block = NULL;
+
+    size = arena_align(size);
+    if ((block != NULL) && ((block->size - block->used) >= size))
+    {
+        block->used += size;
+        return arena_block_data(block) + block->used - size;
+    }
+
+    /* large allocations get a block of their own behind the current one, so its free space is not wasted */
+    if ((block != NULL) && (size > (arena->block_size / 4)))
+    {
+        new_block = arena_new_block(size);
+        if (new_block == NULL)
+        {
+            return NULL;
+        }
+        new_block->next = block->next;
+        block->next = new_block;
+    }
+    else
+    {
+        new_block = arena_new_block((size > arena->block_size) ? size : arena->block_size);
+        if (new_block == NULL)
+        {
+            return NULL;
+        }
+        new_block->next = block;
+        arena->blocks = new_block;
+    }
+
+    new_block->used = size;
+    return arena_block_data(new_block);
+}
+
+/* A node pool slab: a header followed by slab_nodes nodes */
+typedef struct cJSON_PoolSlab
+{
+    struct cJSON_PoolSlab *next;
+} cJSON_PoolSlab;
+
+struct cJSON_NodePool
+{
+    cJSON_PoolSlab *slabs;
+    cJSON *free_nodes; /* linked through next */
+    size_t slab_nodes;
+};
+
+#define pool_slab_nodes(slab) ((cJSON*)(((unsigned char*)(slab)) + arena_align(sizeof(cJSON_PoolSlab))))
+
+/* take a node off the free list, carving a new slab into nodes when it is empty */
+static cJSON *pool_take(cJSON_NodePool * const pool)
+{
+    cJSON *node = pool->free_nodes;
+
+    if (node == NULL)
+    {
+        cJSON *nodes = NULL;
+        size_t index = 0;
+        cJSON_PoolSlab *slab = (cJSON_PoolSlab*)global_hooks.allocate(arena_align(sizeof(cJSON_PoolSlab)) + (pool->slab_nodes * sizeof(cJSON)));
+        if (slab == NULL)
+        {
+            return NULL;
+        }
+        slab->next = pool->slabs;
+        pool->slabs = slab;
+
+        nodes = pool_slab_nodes(slab);
+        for (index = 0; (index + 1) < pool->slab_nodes; index++)
+        {
+            nodes[index].next = &nodes[index + 1];
+        }
+        nodes[pool->slab_nodes - 1].next = NULL;
+        node = nodes;
+    }
+    pool->free_nodes = node->next;
+
+    return node;
+}
+
+static void pool_give(cJSON_NodePool * const pool, cJSON * const node)
+{
+    node->next = pool->free_nodes;
+    pool->free_nodes = node;
+}
+
+/* allocate through the hooks, or from their arena if they have one */
+static void *allocate_with_hooks(const internal_hooks * const hooks, size_t size)
+{
+    if (hooks->arena != NULL)
+    {
+        return arena_allocate(hooks->arena, size);
+    }
+
+    return hooks->allocate(size);
+}
+
+/* arena memory is only released by resetting the arena */
+static void deallocate_with_hooks(const internal_hooks * const hooks, void *pointer)
+{
+    if (hooks->arena == NULL)
+    {
+        hooks->deallocate(pointer);
+    }
+}
 
 static unsigned char* cJSON_strdup(const unsigned char* string, const internal_hooks * const hooks)
 {
@@ -206,41 +370,55 @@ static unsigned char* cJSON_strdup(const unsigned char* string, const internal_h
     return copy;
 }
 
-CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
+/* turn user supplied hooks into internal ones; missing functions fall back to malloc and free */
+static void set_hooks(internal_hooks * const target, const cJSON_Hooks * const hooks)
 {
-    if (hooks == NULL)
-    {
-        /* Reset hooks */
-        global_hooks.allocate = malloc;
-        global_hooks.deallocate = free;
-        global_hooks.reallocate = realloc;
-        return;
-    }
-
-    global_hooks.allocate = malloc;
+    target->allocate = malloc;
     if (hooks->malloc_fn != NULL)
     {
-        global_hooks.allocate = hooks->malloc_fn;
+        target->allocate = hooks->malloc_fn;
     }
 
-    global_hooks.deallocate = free;
+    target->deallocate = free;
     if (hooks->free_fn != NULL)
     {
-        global_hooks.deallocate = hooks->free_fn;
+        target->deallocate = hooks->free_fn;
     }
 
     /* use realloc only if both free and malloc are used */
-    global_hooks.reallocate = NULL;
-    if ((global_hooks.allocate == malloc) && (global_hooks.deallocate == free))
+    target->reallocate = NULL;
+    if ((target->allocate == malloc) && (target->deallocate == free))
+    {
+        target->reallocate = realloc;
+    }
+}
+
+CJSON_PUBLIC(void) cJSON_InitHooks(cJSON_Hooks* hooks)
+{
+    if (hooks == NULL)
     {
+        /* Reset hooks */
+        global_hooks.allocate = malloc;
+        global_hooks.deallocate = free;
         global_hooks.reallocate = realloc;
+        return;
     }
+
+    set_hooks(&global_hooks, hooks);
 }
 
 /* Internal constructor. */
 static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
 {
-    cJSON* node = (cJSON*)hooks->allocate(sizeof(cJSON));
+    cJSON* node = NULL;
+    if (hooks->pool != NULL)
+    {
+        node = pool_take(hooks->pool);
+    }
+    else
+    {
+        node = (cJSON*)allocate_with_hooks(hooks, sizeof(cJSON));
+    }
     if (node)
     {
         memset(node, '\0', sizeof(cJSON));
@@ -249,937 +427,3920 @@ static cJSON *cJSON_New_Item(const internal_hooks * const hooks)
     return node;
 }
 
-/* Delete a cJSON structure. */
-CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
+static void drop_index(cJSON * const item);
+
+/* Delete a cJSON structure with the hooks it was allocated with.
+ * This does not recurse: an item with children hands its first child up in front of itself, keeps the rest,
+ * and becomes that child's next sibling, so children are still freed before their parent without a stack. */
+static void delete_with_hooks(cJSON *item, const internal_hooks * const hooks)
 {
     cJSON *next = NULL;
+    cJSON *child = NULL;
     while (item != NULL)
     {
-        next = item->next;
         if (!(item->type & cJSON_IsReference) && (item->child != NULL))
         {
-            cJSON_Delete(item->child);
+            child = item->child;
+            item->child = child->next;
+            child->next = item;
+            item = child;
+            continue;
         }
+
+        next = item->next;
         if (!(item->type & cJSON_IsReference) && (item->valuestring != NULL))
         {
-            global_hooks.deallocate(item->valuestring);
+            hooks->deallocate(item->valuestring);
         }
         if (!(item->type & cJSON_StringIsConst) && (item->string != NULL))
         {
-            global_hooks.deallocate(item->string);
+            hooks->deallocate(item->string);
+        }
+        if (!(item->type & cJSON_IsReference))
+        {
+            drop_index(item);
+        }
+        if (hooks->pool != NULL)
+        {
+            pool_give(hooks->pool, item);
+        }
+        else
+        {
+            hooks->deallocate(item);
         }
-        global_hooks.deallocate(item);
         item = next;
     }
 }
 
-/* get the decimal point character of the current locale */
-static unsigned char get_decimal_point(void)
+/* Delete a cJSON structure. */
+CJSON_PUBLIC(void) cJSON_Delete(cJSON *item)
 {
-#ifdef ENABLE_LOCALES
-    struct lconv *lconv = localeconv();
-    return (unsigned char) lconv->decimal_point[0];
-#else
-    return '.';
-#endif
+    delete_with_hooks(item, &global_hooks);
 }
 
-typedef struct
+/* Delete a partially parsed tree; trees in an arena go away with the arena. */
+static void delete_parsed(cJSON *item, const internal_hooks * const hooks)
 {
-    const unsigned char *content;
-    size_t length;
-    size_t offset;
-    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
-    internal_hooks hooks;
-} parse_buffer;
+    if (hooks->arena == NULL)
+    {
+        delete_with_hooks(item, hooks);
+    }
+}
 
-/* check if the given size is left to read in a given parse buffer (starting with 1) */
-#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
-/* check if the buffer can be accessed at the given index (starting with 0) */
-#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
-#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
-/* get a pointer to the buffer at the position */
-#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+/* Index over the children of an object or array (see cJSON::index).
+ * Objects get an open addressing table keyed on the lowercased name, so both lookup flavours can use it;
+ * arrays get their children in order. */
+typedef struct cJSON_IndexEntry
+{
+    cJSON *item;
+    unsigned int hash;
+} cJSON_IndexEntry;
 
-/* Parse the input text to generate a number, and populate the result into item. */
-static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
+typedef struct cJSON_Index
 {
-    double number = 0;
-    unsigned char *after_end = NULL;
-    unsigned char number_c_string[64];
-    unsigned char decimal_point = get_decimal_point();
-    size_t i = 0;
+    size_t count; /* number of children */
+    size_t size; /* slots of an object table (a power of two) or capacity of an array index */
+    cJSON *first; /* first and last child the index knows of, see index_in_step */
+    cJSON *last;
+    void (CJSON_CDECL *deallocate)(void *pointer); /* frees the index, whatever cJSON_InitHooks has installed since */
+    union
+    {
+        cJSON_IndexEntry slots[1];
+        cJSON *items[1];
+    } table;
+} cJSON_Index;
+
+static cJSON_bool is_array(const cJSON * const item)
+{
+    return (item->type & 0xFF) == cJSON_Array;
+}
 
-    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+static unsigned int hash_key(const unsigned char *key)
+{
+    unsigned int hash = 2166136261U;
+
+    for (; *key != '\0'; key++)
     {
-        return false;
+        hash ^= (unsigned int)tolower(*key);
+        hash *= 16777619U;
     }
 
-    /* copy the number into a temporary buffer and replace '.' with the decimal point
-     * of the current locale (for strtod)
-     * This also takes care of '\0' not necessarily being available for marking the end of the input */
-    for (i = 0; (i < (sizeof(number_c_string) - 1)) && can_access_at_index(input_buffer, i); i++)
-    {
-        switch (buffer_at_offset(input_buffer)[i])
-        {
-            case '0':
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case '+':
-            case '-':
-            case 'e':
-            case 'E':
-                number_c_string[i] = buffer_at_offset(input_buffer)[i];
-                break;
+    return hash;
+}
 
-            case '.':
-                number_c_string[i] = decimal_point;
-                break;
+static void insert_indexed_item(cJSON_Index * const index, cJSON * const item)
+{
+    size_t mask = index->size - 1;
+    unsigned int hash = 0;
+    size_t slot = 0;
 
-            default:
-                goto loop_end;
-        }
+    index->count++;
+    if (item->string == NULL)
+    {
+        return;
     }
-loop_end:
-    number_c_string[i] = '\0';
 
-    number = strtod((const char*)number_c_string, (char**)&after_end);
-    if (number_c_string == after_end)
+    hash = hash_key((const unsigned char*)item->string);
+    slot = hash & mask;
+    while (index->table.slots[slot].item != NULL)
     {
-        return false; /* parse_error */
+        slot = (slot + 1) & mask;
     }
+    index->table.slots[slot].item = item;
+    index->table.slots[slot].hash = hash;
+}
 
-    item->valuedouble = number;
+/* build the table over the children of an object, sized for 'count' of them and kept at most half full */
+static cJSON_Index *build_object_index(cJSON *head, size_t count)
+{
+    cJSON_Index *index = NULL;
+    cJSON *current_item = NULL;
+    size_t slot_count = 1;
 
-    /* use saturation in case of overflow */
-    if (number >= INT_MAX)
+    while (slot_count < (count * 2))
     {
-        item->valueint = INT_MAX;
+        slot_count <<= 1;
     }
-    else if (number <= (double)INT_MIN)
+
+    index = (cJSON_Index*)global_hooks.allocate(sizeof(cJSON_Index) + ((slot_count - 1) * sizeof(cJSON_IndexEntry)));
+    if (index == NULL)
     {
-        item->valueint = INT_MIN;
+        return NULL; /* lookups simply walk the list */
     }
-    else
+    index->count = 0;
+    index->size = slot_count;
+    index->first = head;
+    index->last = NULL;
+    index->deallocate = global_hooks.deallocate;
+    memset(index->table.slots, '\0', slot_count * sizeof(cJSON_IndexEntry));
+
+    /* inserting in list order keeps equal keys in list order along the probe sequence, so a lookup finds the first one like a list walk would */
+    for (current_item = head; current_item != NULL; current_item = current_item->next)
     {
-        item->valueint = (int)number;
+        insert_indexed_item(index, current_item);
+        index->last = current_item;
     }
 
-    item->type = cJSON_Number;
-
-    input_buffer->offset += (size_t)(after_end - number_c_string);
-    return true;
+    return index;
 }
 
-/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
-CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+static cJSON *find_indexed_item(const cJSON_Index * const index, const char * const name, const cJSON_bool case_sensitive)
 {
-    if (number >= INT_MAX)
+    unsigned int hash = hash_key((const unsigned char*)name);
+    size_t mask = index->size - 1;
+    size_t slot = hash & mask;
+    const cJSON_IndexEntry *entry = NULL;
+
+    for (entry = &index->table.slots[slot]; entry->item != NULL; slot = (slot + 1) & mask, entry = &index->table.slots[slot])
     {
-        object->valueint = INT_MAX;
+        if (entry->hash != hash)
+        {
+            continue;
+        }
+        if (case_sensitive ? (strcmp(name, entry->item->string) == 0) : (case_insensitive_strcmp((const unsigned char*)name, (const unsigned char*)entry->item->string) == 0))
+        {
+            return entry->item;
+        }
     }
-    else if (number <= (double)INT_MIN)
+
+    return NULL;
+}
+
+static cJSON_Index *allocate_array_index(size_t capacity)
+{
+    cJSON_Index *index = (cJSON_Index*)global_hooks.allocate(sizeof(cJSON_Index) + ((capacity - 1) * sizeof(cJSON*)));
+    if (index != NULL)
     {
-        object->valueint = INT_MIN;
+        index->count = 0;
+        index->size = capacity;
+        index->first = NULL;
+        index->last = NULL;
+        index->deallocate = global_hooks.deallocate;
     }
-    else
+
+    return index;
+}
+
+/* the index is freed the way it was allocated, whichever hooks the tree is being deleted with */
+static void drop_index(cJSON * const item)
+{
+    if ((item != NULL) && (item->index != NULL))
     {
-        object->valueint = (int)number;
+        item->index->deallocate(item->index);
+        item->index = NULL;
     }
+}
 
-    return object->valuedouble = number;
+CJSON_PUBLIC(void) cJSON_DropIndex(cJSON *item)
+{
+    drop_index(item);
 }
 
-CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexArray(cJSON *array)
 {
-    char *copy = NULL;
-    /* if object's type is not cJSON_String or is cJSON_IsReference, it should not set valuestring */
-    if (!(object->type & cJSON_String) || (object->type & cJSON_IsReference))
+    cJSON_Index *index = NULL;
+    cJSON *current_item = NULL;
+    size_t count = 0;
+    size_t capacity = 16;
+
+    if ((array == NULL) || !is_array(array))
     {
-        return NULL;
+        return false;
     }
-    if (strlen(valuestring) <= strlen(object->valuestring))
+    if (array->index != NULL)
     {
-        strcpy(object->valuestring, valuestring);
-        return object->valuestring;
+        return true;
     }
-    copy = (char*) cJSON_strdup((const unsigned char*)valuestring, &global_hooks);
-    if (copy == NULL)
+
+    for (current_item = array->child; current_item != NULL; current_item = current_item->next)
     {
-        return NULL;
+        count++;
     }
-    if (object->valuestring != NULL)
+    while (capacity < count)
     {
-        cJSON_free(object->valuestring);
+        capacity <<= 1;
     }
-    object->valuestring = copy;
 
-    return copy;
-}
+    index = allocate_array_index(capacity);
+    if (index == NULL)
+    {
+        return false;
+    }
+    for (current_item = array->child; current_item != NULL; current_item = current_item->next)
+    {
+        index->table.items[index->count++] = current_item;
+        index->last = current_item;
+    }
+    index->first = array->child;
+    array->index = index;
 
-typedef struct
-{
-    unsigned char *buffer;
-    size_t length;
-    size_t offset;
-    size_t depth; /* current nesting depth (for formatted printing) */
-    cJSON_bool noalloc;
-    cJSON_bool format; /* is this print a formatted print */
-    internal_hooks hooks;
-} printbuffer;
+    return true;
+}
 
-/* realloc printbuffer if necessary to have at least "needed" bytes more */
-static unsigned char* ensure(printbuffer * const p, size_t needed)
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON *object)
 {
-    unsigned char *newbuffer = NULL;
-    size_t newsize = 0;
+    cJSON *current_item = NULL;
+    size_t count = 0;
 
-    if ((p == NULL) || (p->buffer == NULL))
+    if ((object == NULL) || ((object->type & 0xFF) != cJSON_Object))
     {
-        return NULL;
+        return false;
     }
-
-    if ((p->length > 0) && (p->offset >= p->length))
+    if (object->index != NULL)
     {
-        /* make sure that offset is valid */
-        return NULL;
+        return true;
     }
 
-    if (needed > INT_MAX)
+    for (current_item = object->child; current_item != NULL; current_item = current_item->next)
     {
-        /* sizes bigger than INT_MAX are currently not supported */
-        return NULL;
+        count++;
     }
+    /* room to grow, so the first appends don't rebuild the table */
+    object->index = build_object_index(object->child, (count < 8) ? 8 : count);
 
-    needed += p->offset + 1;
-    if (needed <= p->length)
+    return object->index != NULL;
+}
+
+/* an index is only trusted while the list still starts and ends where it did when the index was last brought up to date,
+ * so children pushed or popped at either end by hand fall back to walking the list */
+static cJSON_bool index_in_step(const cJSON * const parent)
+{
+    const cJSON_Index *index = parent->index;
+
+    return (index != NULL) && (index->first == parent->child) && (index->last == ((parent->child != NULL) ? parent->child->prev : NULL));
+}
+
+/* keep the index of 'parent' in step with 'item' having been appended to it, dropping it if that is not possible */
+static void append_to_index(cJSON * const parent, cJSON * const item)
+{
+    cJSON_Index *index = parent->index;
+    cJSON *previous = (parent->child == item) ? NULL : item->prev;
+
+    if (index == NULL)
     {
-        return p->buffer + p->offset;
+        return;
     }
-
-    if (p->noalloc) {
-        return NULL;
+    if ((index->last != previous) || (index->first != ((previous != NULL) ? parent->child : NULL)))
+    {
+        /* the list was changed by hand before this append */
+        cJSON_DropIndex(parent);
+        return;
     }
 
-    /* calculate new buffer size */
-    if (needed > (INT_MAX / 2))
+    if (is_array(parent))
     {
-        /* overflow of int, use INT_MAX if possible */
-        if (needed <= INT_MAX)
-        {
-            newsize = INT_MAX;
-        }
-        else
+        if (index->count == index->size)
         {
-            return NULL;
+            cJSON_Index *grown = allocate_array_index(index->size * 2);
+            if (grown == NULL)
+            {
+                cJSON_DropIndex(parent);
+                return;
+            }
+            memcpy(grown->table.items, index->table.items, index->count * sizeof(cJSON*));
+            grown->count = index->count;
+            cJSON_DropIndex(parent);
+            parent->index = index = grown;
         }
+        index->table.items[index->count++] = item;
+        index->first = parent->child;
+        index->last = item;
+        return;
     }
-    else
+
+    if (((index->count + 1) * 2) > index->size)
     {
-        newsize = needed * 2;
+        /* rebuild with room to grow, the list already holds the new item */
+        size_t count = index->count + 1;
+        cJSON_DropIndex(parent);
+        parent->index = build_object_index(parent->child, count * 2);
+        return;
     }
+    insert_indexed_item(index, item);
+    index->first = parent->child;
+    index->last = item;
+}
 
-    if (p->hooks.reallocate != NULL)
+/* get the decimal point character of the current locale */
+static unsigned char get_decimal_point(void)
+{
+#ifdef ENABLE_LOCALES
+    struct lconv *lconv = localeconv();
+    return (unsigned char) lconv->decimal_point[0];
+#else
+    return '.';
+#endif
+}
+
+typedef struct
+{
+    const unsigned char *content;
+    size_t length;
+    size_t offset;
+    size_t depth; /* How deeply nested (in arrays/objects) is the input at the current offset. */
+    internal_hooks hooks;
+    unsigned char *in_situ; /* when set, the writable content: strings are unescaped in place and not copied */
+} parse_buffer;
+
+/* check if the given size is left to read in a given parse buffer (starting with 1) */
+#define can_read(buffer, size) ((buffer != NULL) && (((buffer)->offset + size) <= (buffer)->length))
+/* check if the buffer can be accessed at the given index (starting with 0) */
+#define can_access_at_index(buffer, index) ((buffer != NULL) && (((buffer)->offset + index) < (buffer)->length))
+#define cannot_access_at_index(buffer, index) (!can_access_at_index(buffer, index))
+
+/* get a pointer to the buffer at the position */
+#define buffer_at_offset(buffer) ((buffer)->content + (buffer)->offset)
+
+#ifdef CJSON_SIMD_SSE2
+/* index of the lowest set bit of a non-zero mask */
+#if defined(_MSC_VER) && !defined(__clang__)
+static unsigned int first_set_bit(const unsigned int mask)
+{
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return (unsigned int)index;
+}
+#else
+#define first_set_bit(mask) ((unsigned int)__builtin_ctz(mask))
+#endif
+#endif
+
+/* the first quote or backslash in [pointer, end), or end if there is none */
+static const unsigned char *find_quote_or_backslash(const unsigned char *pointer, const unsigned char * const end)
+{
+#ifdef CJSON_SIMD_AVX2
+    const __m256i quotes_32 = _mm256_set1_epi8('\"');
+    const __m256i backslashes_32 = _mm256_set1_epi8('\\');
+#endif
+#ifdef CJSON_SIMD_SSE2
+    const __m128i quotes = _mm_set1_epi8('\"');
+    const __m128i backslashes = _mm_set1_epi8('\\');
+#endif
+
+#ifdef CJSON_SIMD_AVX2
+    while ((end - pointer) >= 32)
     {
-        /* reallocate with realloc if available */
-        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize);
-        if (newbuffer == NULL)
+        const __m256i bytes = _mm256_loadu_si256((const __m256i*)(const void*)pointer);
+        const unsigned int mask = (unsigned int)_mm256_movemask_epi8(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quotes_32), _mm256_cmpeq_epi8(bytes, backslashes_32)));
+        if (mask != 0)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            return pointer + first_set_bit(mask);
         }
+        pointer += 32;
     }
-    else
+#endif
+#ifdef CJSON_SIMD_SSE2
+    while ((end - pointer) >= 16)
     {
-        /* otherwise reallocate manually */
-        newbuffer = (unsigned char*)p->hooks.allocate(newsize);
-        if (!newbuffer)
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+        const unsigned int mask = (unsigned int)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(bytes, quotes), _mm_cmpeq_epi8(bytes, backslashes)));
+        if (mask != 0)
         {
-            p->hooks.deallocate(p->buffer);
-            p->length = 0;
-            p->buffer = NULL;
-
-            return NULL;
+            return pointer + first_set_bit(mask);
         }
-
-        memcpy(newbuffer, p->buffer, p->offset + 1);
-        p->hooks.deallocate(p->buffer);
+        pointer += 16;
+    }
+#endif
+    while ((pointer < end) && (*pointer != '\"') && (*pointer != '\\'))
+    {
+        pointer++;
     }
-    p->length = newsize;
-    p->buffer = newbuffer;
 
-    return newbuffer + p->offset;
+    return pointer;
 }
 
-/* calculate the new length of the string in a printbuffer and update the offset */
-static void update_offset(printbuffer * const buffer)
+/* the first byte after the whitespace (any byte up to 32) starting at pointer, or end */
+static const unsigned char *skip_whitespace_run(const unsigned char *pointer, const unsigned char * const end)
 {
-    const unsigned char *buffer_pointer = NULL;
-    if ((buffer == NULL) || (buffer->buffer == NULL))
+#ifdef CJSON_SIMD_SSE2
+    const __m128i spaces = _mm_set1_epi8(32);
+#endif
+
+    /* most runs are empty or a single space, which is not worth a vector load */
+    if ((pointer < end) && (*pointer > 32))
     {
-        return;
+        return pointer;
+    }
+    if (((pointer + 1) < end) && (pointer[1] > 32))
+    {
+        return pointer + 1;
     }
-    buffer_pointer = buffer->buffer + buffer->offset;
 
-    buffer->offset += strlen((const char*)buffer_pointer);
+#ifdef CJSON_SIMD_SSE2
+    while ((end - pointer) >= 16)
+    {
+        /* a byte is whitespace when the unsigned maximum of it and 32 is 32 */
+        const __m128i bytes = _mm_loadu_si128((const __m128i*)(const void*)pointer);
+        const unsigned int mask = (~(unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(bytes, spaces), spaces))) & 0xFFFFU;
+        if (mask != 0)
+        {
+            return pointer + first_set_bit(mask);
+        }
+        pointer += 16;
+    }
+#endif
+    while ((pointer < end) && (*pointer <= 32))
+    {
+        pointer++;
+    }
+
+    return pointer;
 }
 
-/* securely comparison of floating-point variables */
-static cJSON_bool compare_double(double a, double b)
+/* Parse the input text to generate a number, and populate the result into item. */
+/* Clinger's fast path needs every double operation to be rounded once, which x87 extended precision doesn't do. */
+#if (defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0)) || defined(__x86_64__) || defined(_M_X64) || defined(__aarch64__) || defined(_M_ARM64)
+#define CJSON_FAST_NUMBERS
+#endif
+
+static cJSON_bool is_number_character(const unsigned char character)
 {
-    double maxVal = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
-    return (fabs(a - b) <= maxVal * DBL_EPSILON);
+    return ((character >= '0') && (character <= '9')) || (character == '+') || (character == '-') || (character == '.') || (character == 'e') || (character == 'E');
 }
 
-/* Render the number nicely from the given item into a string. */
-static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+#ifdef CJSON_FAST_NUMBERS
+/* every power of ten up to 10^22 is exact in a double */
+static const double exact_powers_of_ten[] =
 {
-    unsigned char *output_pointer = NULL;
-    double d = item->valuedouble;
-    int length = 0;
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/* largest value that can take another digit and stay an integer of at most 2^53 */
+#define FAST_SIGNIFICAND_LIMIT 900719925474099.0
+
+/* Parse the number straight from the input when its digits fit a double exactly and its power of ten is exact as well:
+ * a single multiplication or division then rounds correctly, exactly like strtod.
+ * Anything else (long significands, large exponents, sloppy syntax or the 63 character limit of
+ * the strtod path) returns false and is left to strtod. */
+static cJSON_bool parse_number_fast(const parse_buffer * const input_buffer, double * const number, size_t * const length)
+{
+    const unsigned char *input = buffer_at_offset(input_buffer);
+    size_t available = input_buffer->length - input_buffer->offset;
+    size_t limit = (available < 63) ? available : 63;
     size_t i = 0;
-    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
-    unsigned char decimal_point = get_decimal_point();
-    double test = 0.0;
+    double significand = 0;
+    int exponent = 0;
+    int explicit_exponent = 0;
+    cJSON_bool negative = false;
+    cJSON_bool exponent_negative = false;
 
-    if (output_buffer == NULL)
+    if ((i < limit) && (input[i] == '-'))
     {
-        return false;
+        negative = true;
+        i++;
     }
-
-    /* This checks for NaN and Infinity */
-    if (isnan(d) || isinf(d))
+    if ((i >= limit) || (input[i] < '0') || (input[i] > '9'))
     {
-        length = sprintf((char*)number_buffer, "null");
+        return false;
     }
-	else if(d == (double)item->valueint)
-	{
-		length = sprintf((char*)number_buffer, "%d", item->valueint);
-	}
-    else
+    for (; (i < limit) && (input[i] >= '0') && (input[i] <= '9'); i++)
     {
-        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
-        length = sprintf((char*)number_buffer, "%1.15g", d);
+        if (significand >= FAST_SIGNIFICAND_LIMIT)
+        {
+            return false;
+        }
+        significand = (significand * 10) + (input[i] - '0');
+    }
 
-        /* Check whether the original double can be recovered */
-        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
+    if ((i < limit) && (input[i] == '.'))
+    {
+        i++;
+        if ((i >= limit) || (input[i] < '0') || (input[i] > '9'))
         {
-            /* If not, print with 17 decimal places of precision */
-            length = sprintf((char*)number_buffer, "%1.17g", d);
+            return false;
+        }
+        for (; (i < limit) && (input[i] >= '0') && (input[i] <= '9'); i++)
+        {
+            if (significand >= FAST_SIGNIFICAND_LIMIT)
+            {
+                return false;
+            }
+            significand = (significand * 10) + (input[i] - '0');
+            exponent--;
         }
     }
 
-    /* sprintf failed or buffer overrun occurred */
-    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    if ((i < limit) && ((input[i] == 'e') || (input[i] == 'E')))
     {
-        return false;
+        i++;
+        if ((i < limit) && ((input[i] == '+') || (input[i] == '-')))
+        {
+            exponent_negative = (input[i] == '-');
+            i++;
+        }
+        if ((i >= limit) || (input[i] < '0') || (input[i] > '9'))
+        {
+            return false;
+        }
+        for (; (i < limit) && (input[i] >= '0') && (input[i] <= '9'); i++)
+        {
+            if (explicit_exponent > 9999)
+            {
+                return false;
+            }
+            explicit_exponent = (explicit_exponent * 10) + (input[i] - '0');
+        }
+        exponent += exponent_negative ? -explicit_exponent : explicit_exponent;
     }
 
-    /* reserve appropriate space in the output */
-    output_pointer = ensure(output_buffer, (size_t)length + sizeof(""));
-    if (output_pointer == NULL)
+    /* strtod would have read on (or the number was cut at 63 characters) */
+    if ((i < available) && is_number_character(input[i]))
     {
         return false;
     }
 
-    /* copy the printed number to the output and replace locale
-     * dependent decimal point with '.' */
-    for (i = 0; i < ((size_t)length); i++)
+    if (significand > 0)
     {
-        if (number_buffer[i] == decimal_point)
+        if (exponent < -22)
         {
-            output_pointer[i] = '.';
-            continue;
+            return false;
+        }
+        /* 123e25 is 123000e22: move surplus powers into the significand while it stays exact */
+        for (; exponent > 22; exponent--)
+        {
+            if (significand >= FAST_SIGNIFICAND_LIMIT)
+            {
+                return false;
+            }
+            significand *= 10;
+        }
+        if (exponent < 0)
+        {
+            significand /= exact_powers_of_ten[-exponent];
+        }
+        else
+        {
+            significand *= exact_powers_of_ten[exponent];
         }
-
-        output_pointer[i] = number_buffer[i];
     }
-    output_pointer[i] = '\0';
-
-    output_buffer->offset += (size_t)length;
 
+    *number = negative ? -significand : significand;
+    *length = i;
     return true;
 }
+#else
+static cJSON_bool parse_number_fast(const parse_buffer * const input_buffer, double * const number, size_t * const length)
+{
+    (void)input_buffer;
+    (void)number;
+    (void)length;
+    return false;
+}
+#endif
 
-/* parse 4 digit hexadecimal number */
-static unsigned parse_hex4(const unsigned char * const input)
+static cJSON_bool parse_number(cJSON * const item, parse_buffer * const input_buffer)
 {
-    unsigned int h = 0;
+    double number = 0;
+    unsigned char *after_end = NULL;
+    unsigned char number_c_string[64];
+    unsigned char decimal_point = 0;
+    size_t length = 0;
     size_t i = 0;
 
-    for (i = 0; i < 4; i++)
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
     {
-        /* parse digit */
-        if ((input[i] >= '0') && (input[i] <= '9'))
-        {
-            h += (unsigned int) input[i] - '0';
-        }
+        return false;
+    }
+
+    if (parse_number_fast(input_buffer, &number, &length))
+    {
+        goto parsed;
+    }
+
+    decimal_point = get_decimal_point();
+
+    /* copy the number into a temporary buffer and replace '.' with the decimal point
+     * of the current locale (for strtod)
+     * This also takes care of '\0' not necessarily being available for marking the end of the input */
+    for (i = 0; (i < (sizeof(number_c_string) - 1)) && can_access_at_index(input_buffer, i); i++)
+    {
+        switch (buffer_at_offset(input_buffer)[i])
+        {
+            case '0':
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '+':
+            case '-':
+            case 'e':
+            case 'E':
+                number_c_string[i] = buffer_at_offset(input_buffer)[i];
+                break;
+
+            case '.':
+                number_c_string[i] = decimal_point;
+                break;
+
+            default:
+                goto loop_end;
+        }
+    }
+loop_end:
+    number_c_string[i] = '\0';
+
+    number = strtod((const char*)number_c_string, (char**)&after_end);
+    if (number_c_string == after_end)
+    {
+        return false; /* parse_error */
+    }
+    length = (size_t)(after_end - number_c_string);
+
+parsed:
+    item->valuedouble = number;
+
+    /* use saturation in case of overflow */
+    if (number >= INT_MAX)
+    {
+        item->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        item->valueint = INT_MIN;
+    }
+    else
+    {
+        item->valueint = (int)number;
+    }
+
+    item->type = cJSON_Number;
+
+    input_buffer->offset += length;
+    return true;
+}
+
+/* don't ask me, but the original cJSON_SetNumberValue returns an integer or double */
+CJSON_PUBLIC(double) cJSON_SetNumberHelper(cJSON *object, double number)
+{
+    if (number >= INT_MAX)
+    {
+        object->valueint = INT_MAX;
+    }
+    else if (number <= (double)INT_MIN)
+    {
+        object->valueint = INT_MIN;
+    }
+    else
+    {
+        object->valueint = (int)number;
+    }
+
+    return object->valuedouble = number;
+}
+
+CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
+{
+    char *copy = NULL;
+    /* if object's type is not cJSON_String or is cJSON_IsReference, it should not set valuestring */
+    if (!(object->type & cJSON_String) || (object->type & cJSON_IsReference))
+    {
+        return NULL;
+    }
+    if (strlen(valuestring) <= strlen(object->valuestring))
+    {
+        strcpy(object->valuestring, valuestring);
+        return object->valuestring;
+    }
+    copy = (char*) cJSON_strdup((const unsigned char*)valuestring, &global_hooks);
+    if (copy == NULL)
+    {
+        return NULL;
+    }
+    if (object->valuestring != NULL)
+    {
+        cJSON_free(object->valuestring);
+    }
+    object->valuestring = copy;
+
+    return copy;
+}
+
+typedef struct
+{
+    unsigned char *buffer;
+    size_t length;
+    size_t offset;
+    size_t depth; /* current nesting depth (for formatted printing) */
+    cJSON_bool noalloc;
+    cJSON_bool format; /* is this print a formatted print */
+    internal_hooks hooks;
+    cJSON_PrintSink sink; /* when set, a full buffer is handed to the sink and reused instead of growing */
+    void *sink_context;
+} printbuffer;
+
+/* pass the text printed so far on to the sink, so the buffer can be filled again from the start */
+static cJSON_bool flush_printbuffer(printbuffer * const p)
+{
+    if ((p->offset > 0) && !p->sink(p->sink_context, (const char*)p->buffer, p->offset))
+    {
+        return false;
+    }
+    p->offset = 0;
+
+    return true;
+}
+
+/* realloc printbuffer if necessary to have at least "needed" bytes more */
+static unsigned char* ensure(printbuffer * const p, size_t needed)
+{
+    unsigned char *newbuffer = NULL;
+    size_t newsize = 0;
+
+    if ((p == NULL) || (p->buffer == NULL))
+    {
+        return NULL;
+    }
+
+    if ((p->length > 0) && (p->offset >= p->length))
+    {
+        /* make sure that offset is valid */
+        return NULL;
+    }
+
+    if (needed > INT_MAX)
+    {
+        /* sizes bigger than INT_MAX are currently not supported */
+        return NULL;
+    }
+
+    needed += p->offset + 1;
+    if (needed <= p->length)
+    {
+        return p->buffer + p->offset;
+    }
+
+    if (p->sink != NULL)
+    {
+        needed -= p->offset;
+        if (!flush_printbuffer(p))
+        {
+            return NULL;
+        }
+        if (needed <= p->length)
+        {
+            return p->buffer;
+        }
+        /* a single string or raw value that is longer than the whole buffer, grow it for that */
+    }
+
+    if (p->noalloc) {
+        return NULL;
+    }
+
+    /* calculate new buffer size */
+    if (needed > (INT_MAX / 2))
+    {
+        /* overflow of int, use INT_MAX if possible */
+        if (needed <= INT_MAX)
+        {
+            newsize = INT_MAX;
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+    else
+    {
+        newsize = needed * 2;
+    }
+
+    if (p->hooks.reallocate != NULL)
+    {
+        /* reallocate with realloc if available */
+        newbuffer = (unsigned char*)p->hooks.reallocate(p->buffer, newsize);
+        if (newbuffer == NULL)
+        {
+            p->hooks.deallocate(p->buffer);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+    }
+    else
+    {
+        /* otherwise reallocate manually */
+        newbuffer = (unsigned char*)p->hooks.allocate(newsize);
+        if (!newbuffer)
+        {
+            p->hooks.deallocate(p->buffer);
+            p->length = 0;
+            p->buffer = NULL;
+
+            return NULL;
+        }
+
+        memcpy(newbuffer, p->buffer, p->offset + 1);
+        p->hooks.deallocate(p->buffer);
+    }
+    p->length = newsize;
+    p->buffer = newbuffer;
+
+    return newbuffer + p->offset;
+}
+
+/* calculate the new length of the string in a printbuffer and update the offset */
+static void update_offset(printbuffer * const buffer)
+{
+    const unsigned char *buffer_pointer = NULL;
+    if ((buffer == NULL) || (buffer->buffer == NULL))
+    {
+        return;
+    }
+    buffer_pointer = buffer->buffer + buffer->offset;
+
+    buffer->offset += strlen((const char*)buffer_pointer);
+}
+
+/* securely comparison of floating-point variables */
+static cJSON_bool compare_double(double a, double b)
+{
+    double maxVal = fabs(a) > fabs(b) ? fabs(a) : fabs(b);
+    return (fabs(a - b) <= maxVal * DBL_EPSILON);
+}
+
+/* Shortest round-trip printing of doubles with Grisu2 (Florian Loitsch, "Printing Floating-Point Numbers
+ * Quickly and Accurately with Integers"): the digits always read back as the same double and are the
+ * shortest such digits for all but a tiny fraction of values. Needs 64 bit integers. */
+#if defined(ULLONG_MAX)
+#define CJSON_SHORTEST_NUMBERS
+
+typedef unsigned long long grisu_uint64;
+
+/* a double as significand * 2^exponent with a full 64 bit significand */
+typedef struct
+{
+    grisu_uint64 f;
+    int e;
+} grisu_fp;
+
+#define GRISU_SIGNIFICAND_BITS 52
+#define GRISU_HIDDEN_BIT 0x0010000000000000ULL
+#define GRISU_SIGNIFICAND_MASK 0x000FFFFFFFFFFFFFULL
+#define GRISU_EXPONENT_BIAS (0x3FF + GRISU_SIGNIFICAND_BITS)
+
+/* normalized 10^-348, 10^-340, ..., 10^340 */
+static const grisu_uint64 grisu_powers_f[] =
+{
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const short grisu_powers_e[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static const grisu_uint64 grisu_powers_of_ten[] =
+{
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL, 1000000000ULL,
+    10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+    1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+static grisu_fp grisu_multiply(const grisu_fp x, const grisu_fp y)
+{
+    const grisu_uint64 mask = 0xFFFFFFFFULL;
+    grisu_uint64 a = x.f >> 32;
+    grisu_uint64 b = x.f & mask;
+    grisu_uint64 c = y.f >> 32;
+    grisu_uint64 d = y.f & mask;
+    grisu_uint64 middle = ((b * d) >> 32) + ((a * d) & mask) + ((b * c) & mask) + (1ULL << 31); /* round */
+    grisu_fp product;
+
+    product.f = (a * c) + ((a * d) >> 32) + ((b * c) >> 32) + (middle >> 32);
+    product.e = x.e + y.e + 64;
+    return product;
+}
+
+static grisu_fp grisu_normalize(grisu_fp x)
+{
+    while ((x.f & (1ULL << 63)) == 0)
+    {
+        x.f <<= 1;
+        x.e--;
+    }
+    return x;
+}
+
+static void grisu_round(unsigned char * const digits, const int length, const grisu_uint64 delta, grisu_uint64 rest, const grisu_uint64 ten_kappa, const grisu_uint64 distance)
+{
+    while ((rest < distance) && ((delta - rest) >= ten_kappa) && (((rest + ten_kappa) < distance) || ((distance - rest) > ((rest + ten_kappa) - distance))))
+    {
+        digits[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+/* Write the digits of a positive finite double, returning their count; value = digits * 10^(*decimal_exponent) */
+static int grisu2(const double number, unsigned char * const digits, int * const decimal_exponent)
+{
+    grisu_uint64 bits = 0;
+    grisu_fp value;
+    grisu_fp plus;
+    grisu_fp minus;
+    grisu_fp power;
+    grisu_fp one;
+    grisu_uint64 delta = 0;
+    grisu_uint64 distance = 0;
+    grisu_uint64 fraction = 0;
+    unsigned long integral = 0;
+    double scaled = 0;
+    int biased_exponent = 0;
+    int power_index = 0;
+    int kappa = 0;
+    int length = 0;
+
+    memcpy(&bits, &number, sizeof(bits));
+    biased_exponent = (int)((bits >> GRISU_SIGNIFICAND_BITS) & 0x7FF);
+    if (biased_exponent != 0)
+    {
+        value.f = (bits & GRISU_SIGNIFICAND_MASK) + GRISU_HIDDEN_BIT;
+        value.e = biased_exponent - GRISU_EXPONENT_BIAS;
+    }
+    else
+    {
+        value.f = bits & GRISU_SIGNIFICAND_MASK;
+        value.e = 1 - GRISU_EXPONENT_BIAS;
+    }
+
+    /* the boundaries halfway to the neighbouring doubles */
+    plus.f = (value.f << 1) + 1;
+    plus.e = value.e - 1;
+    while ((plus.f & (GRISU_HIDDEN_BIT << 1)) == 0)
+    {
+        plus.f <<= 1;
+        plus.e--;
+    }
+    plus.f <<= 64 - GRISU_SIGNIFICAND_BITS - 2;
+    plus.e -= 64 - GRISU_SIGNIFICAND_BITS - 2;
+    if (value.f == GRISU_HIDDEN_BIT)
+    {
+        minus.f = (value.f << 2) - 1;
+        minus.e = value.e - 2;
+    }
+    else
+    {
+        minus.f = (value.f << 1) - 1;
+        minus.e = value.e - 1;
+    }
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    /* pick the cached power of ten that scales the upper boundary's exponent into [-60, -32] */
+    scaled = ((-61 - plus.e) * 0.30102999566398114) + 347;
+    power_index = (int)scaled;
+    if ((scaled - power_index) > 0.0)
+    {
+        power_index++;
+    }
+    power_index = (power_index >> 3) + 1;
+    *decimal_exponent = -(-348 + (power_index << 3));
+    power.f = grisu_powers_f[power_index];
+    power.e = grisu_powers_e[power_index];
+
+    value = grisu_multiply(grisu_normalize(value), power);
+    plus = grisu_multiply(plus, power);
+    minus = grisu_multiply(minus, power);
+    minus.f++;
+    plus.f--;
+    delta = plus.f - minus.f;
+    distance = plus.f - value.f;
+
+    /* generate digits of the upper boundary until they are within delta of it */
+    one.e = plus.e;
+    one.f = 1ULL << -one.e;
+    integral = (unsigned long)(plus.f >> -one.e);
+    fraction = plus.f & (one.f - 1);
+    for (kappa = 10; (kappa > 0) && (grisu_powers_of_ten[kappa - 1] > integral); kappa--)
+    {
+    }
+
+    while (kappa > 0)
+    {
+        unsigned long digit = (unsigned long)(integral / grisu_powers_of_ten[kappa - 1]);
+        grisu_uint64 rest = 0;
+
+        integral = (unsigned long)(integral % grisu_powers_of_ten[kappa - 1]);
+        if ((digit != 0) || (length != 0))
+        {
+            digits[length++] = (unsigned char)('0' + digit);
+        }
+        kappa--;
+        rest = ((grisu_uint64)integral << -one.e) + fraction;
+        if (rest <= delta)
+        {
+            *decimal_exponent += kappa;
+            grisu_round(digits, length, delta, rest, grisu_powers_of_ten[kappa] << -one.e, distance);
+            return length;
+        }
+    }
+
+    for (;;)
+    {
+        unsigned char digit = 0;
+
+        fraction *= 10;
+        delta *= 10;
+        digit = (unsigned char)(fraction >> -one.e);
+        if ((digit != 0) || (length != 0))
+        {
+            digits[length++] = (unsigned char)('0' + digit);
+        }
+        fraction &= one.f - 1;
+        kappa--;
+        if (fraction < delta)
+        {
+            *decimal_exponent += kappa;
+            grisu_round(digits, length, delta, fraction, one.f, (-kappa < 20) ? (distance * grisu_powers_of_ten[-kappa]) : 0);
+            return length;
+        }
+    }
+}
+
+/* Round the digits to 'target' of them; true (with the digits replaced) if those read back as the same double */
+static cJSON_bool round_digits_exactly(const double number, unsigned char * const digits, const int length, const int target, int * const decimal_exponent)
+{
+    unsigned char rounded[18];
+    int exponent = *decimal_exponent + (length - target);
+    double value = 0;
+    int i = 0;
+
+    memcpy(rounded, digits, (size_t)target);
+    rounded[target] = '\0';
+    if (digits[target] >= '5')
+    {
+        for (i = target - 1; (i >= 0) && (rounded[i] == '9'); i--)
+        {
+            rounded[i] = '0';
+        }
+        if (i < 0)
+        {
+            rounded[0] = '1';
+            exponent++;
+        }
+        else
+        {
+            rounded[i]++;
+        }
+    }
+
+    for (i = 0; i < target; i++)
+    {
+        value = (value * 10) + (rounded[i] - '0');
+    }
+#ifdef CJSON_FAST_NUMBERS
+    if ((value <= 9007199254740992.0) && (exponent >= -22) && (exponent <= 22))
+    {
+        /* exact, see parse_number_fast */
+        value = (exponent < 0) ? (value / exact_powers_of_ten[-exponent]) : (value * exact_powers_of_ten[exponent]);
+    }
+    else
+#endif
+    {
+        char text[32];
+        sprintf(text, "%se%d", (const char*)rounded, exponent);
+        value = strtod(text, NULL);
+    }
+
+    if (!(value == number))
+    {
+        return false;
+    }
+    memcpy(digits, rounded, (size_t)target);
+    *decimal_exponent = exponent;
+    return true;
+}
+
+/* Grisu2 occasionally produces 16 or 17 digits where fewer would do (1.4806839999999999 for 1.480684):
+ * shortest digits of 15 or fewer are found by rounding to 15, shortest digits of 16 by rounding to 16. */
+static int shorten_digits(const double number, unsigned char * const digits, const int length, int * const decimal_exponent)
+{
+    if ((length > 15) && round_digits_exactly(number, digits, length, 15, decimal_exponent))
+    {
+        return 15;
+    }
+    if ((length > 16) && round_digits_exactly(number, digits, length, 16, decimal_exponent))
+    {
+        return 16;
+    }
+
+    return length;
+}
+
+/* Print a finite nonzero double with its shortest digits, laid out like "%1.15g" (or "%1.17g" for longer digits) */
+static int print_shortest(double number, unsigned char * const output)
+{
+    unsigned char digits[20];
+    int length = 0;
+    int decimal_exponent = 0;
+    int exponent = 0;
+    int precision = 0;
+    int position = 0;
+    int i = 0;
+
+    if (number < 0)
+    {
+        output[position++] = '-';
+        number = -number;
+    }
+
+    length = grisu2(number, digits, &decimal_exponent);
+    length = shorten_digits(number, digits, length, &decimal_exponent);
+    while ((length > 1) && (digits[length - 1] == '0'))
+    {
+        length--;
+        decimal_exponent++;
+    }
+
+    exponent = length + decimal_exponent - 1; /* as in d.ddde+XX */
+    precision = (length > 15) ? 17 : 15;
+    if ((exponent < -4) || (exponent >= precision))
+    {
+        output[position++] = digits[0];
+        if (length > 1)
+        {
+            output[position++] = '.';
+            memcpy(output + position, digits + 1, (size_t)(length - 1));
+            position += length - 1;
+        }
+        output[position++] = 'e';
+        output[position++] = (exponent < 0) ? '-' : '+';
+        if (exponent < 0)
+        {
+            exponent = -exponent;
+        }
+        if (exponent >= 100)
+        {
+            output[position++] = (unsigned char)('0' + (exponent / 100));
+        }
+        output[position++] = (unsigned char)('0' + ((exponent / 10) % 10));
+        output[position++] = (unsigned char)('0' + (exponent % 10));
+    }
+    else if (decimal_exponent >= 0)
+    {
+        /* integral, padded with zeros */
+        memcpy(output + position, digits, (size_t)length);
+        position += length;
+        for (i = 0; i < decimal_exponent; i++)
+        {
+            output[position++] = '0';
+        }
+    }
+    else if (exponent >= 0)
+    {
+        memcpy(output + position, digits, (size_t)(exponent + 1));
+        position += exponent + 1;
+        output[position++] = '.';
+        memcpy(output + position, digits + exponent + 1, (size_t)(length - exponent - 1));
+        position += length - exponent - 1;
+    }
+    else
+    {
+        output[position++] = '0';
+        output[position++] = '.';
+        for (i = -1; i > exponent; i--)
+        {
+            output[position++] = '0';
+        }
+        memcpy(output + position, digits, (size_t)length);
+        position += length;
+    }
+    output[position] = '\0';
+
+    return position;
+}
+#endif
+
+/* Render the number nicely from the given item into a string. */
+static cJSON_bool print_number(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    double d = item->valuedouble;
+    int length = 0;
+    size_t i = 0;
+    unsigned char number_buffer[26] = {0}; /* temporary buffer to print the number into */
+    unsigned char decimal_point = get_decimal_point();
+#ifndef CJSON_SHORTEST_NUMBERS
+    double test = 0.0;
+#endif
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    /* This checks for NaN and Infinity */
+    if (isnan(d) || isinf(d))
+    {
+        length = sprintf((char*)number_buffer, "null");
+    }
+	else if(d == (double)item->valueint)
+	{
+		length = sprintf((char*)number_buffer, "%d", item->valueint);
+	}
+    else
+    {
+#ifdef CJSON_SHORTEST_NUMBERS
+        length = print_shortest(d, number_buffer);
+#else
+        /* Try 15 decimal places of precision to avoid nonsignificant nonzero digits */
+        length = sprintf((char*)number_buffer, "%1.15g", d);
+
+        /* Check whether the original double can be recovered */
+        if ((sscanf((char*)number_buffer, "%lg", &test) != 1) || !compare_double((double)test, d))
+        {
+            /* If not, print with 17 decimal places of precision */
+            length = sprintf((char*)number_buffer, "%1.17g", d);
+        }
+#endif
+    }
+
+    /* sprintf failed or buffer overrun occurred */
+    if ((length < 0) || (length > (int)(sizeof(number_buffer) - 1)))
+    {
+        return false;
+    }
+
+    /* reserve appropriate space in the output */
+    output_pointer = ensure(output_buffer, (size_t)length + sizeof(""));
+    if (output_pointer == NULL)
+    {
+        return false;
+    }
+
+    /* copy the printed number to the output and replace locale
+     * dependent decimal point with '.' */
+    for (i = 0; i < ((size_t)length); i++)
+    {
+        if (number_buffer[i] == decimal_point)
+        {
+            output_pointer[i] = '.';
+            continue;
+        }
+
+        output_pointer[i] = number_buffer[i];
+    }
+    output_pointer[i] = '\0';
+
+    output_buffer->offset += (size_t)length;
+
+    return true;
+}
+
+/* parse 4 digit hexadecimal number */
+static unsigned parse_hex4(const unsigned char * const input)
+{
+    unsigned int h = 0;
+    size_t i = 0;
+
+    for (i = 0; i < 4; i++)
+    {
+        /* parse digit */
+        if ((input[i] >= '0') && (input[i] <= '9'))
+        {
+            h += (unsigned int) input[i] - '0';
+        }
         else if ((input[i] >= 'A') && (input[i] <= 'F'))
         {
-            h += (unsigned int) 10 + input[i] - 'A';
+            h += (unsigned int) 10 + input[i] - 'A';
+        }
+        else if ((input[i] >= 'a') && (input[i] <= 'f'))
+        {
+            h += (unsigned int) 10 + input[i] - 'a';
+        }
+        else /* invalid */
+        {
+            return 0;
+        }
+
+        if (i < 3)
+        {
+            /* shift left to make place for the next nibble */
+            h = h << 4;
+        }
+    }
+
+    return h;
+}
+
+/* converts a UTF-16 literal to UTF-8
+ * A literal can be one or two sequences of the form \uXXXX */
+static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer)
+{
+    long unsigned int codepoint = 0;
+    unsigned int first_code = 0;
+    const unsigned char *first_sequence = input_pointer;
+    unsigned char utf8_length = 0;
+    unsigned char utf8_position = 0;
+    unsigned char sequence_length = 0;
+    unsigned char first_byte_mark = 0;
+
+    if ((input_end - first_sequence) < 6)
+    {
+        /* input ends unexpectedly */
+        goto fail;
+    }
+
+    /* get the first utf16 sequence */
+    first_code = parse_hex4(first_sequence + 2);
+
+    /* check that the code is valid */
+    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)))
+    {
+        goto fail;
+    }
+
+    /* UTF16 surrogate pair */
+    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
+    {
+        const unsigned char *second_sequence = first_sequence + 6;
+        unsigned int second_code = 0;
+        sequence_length = 12; /* \uXXXX\uXXXX */
+
+        if ((input_end - second_sequence) < 6)
+        {
+            /* input ends unexpectedly */
+            goto fail;
+        }
+
+        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
+        {
+            /* missing second half of the surrogate pair */
+            goto fail;
+        }
+
+        /* get the second utf16 sequence */
+        second_code = parse_hex4(second_sequence + 2);
+        /* check that the code is valid */
+        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
+        {
+            /* invalid second half of the surrogate pair */
+            goto fail;
+        }
+
+
+        /* calculate the unicode codepoint from the surrogate pair */
+        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
+    }
+    else
+    {
+        sequence_length = 6; /* \uXXXX */
+        codepoint = first_code;
+    }
+
+    /* encode as UTF-8
+     * takes at maximum 4 bytes to encode:
+     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
+    if (codepoint < 0x80)
+    {
+        /* normal ascii, encoding 0xxxxxxx */
+        utf8_length = 1;
+    }
+    else if (codepoint < 0x800)
+    {
+        /* two bytes, encoding 110xxxxx 10xxxxxx */
+        utf8_length = 2;
+        first_byte_mark = 0xC0; /* 11000000 */
+    }
+    else if (codepoint < 0x10000)
+    {
+        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 3;
+        first_byte_mark = 0xE0; /* 11100000 */
+    }
+    else if (codepoint <= 0x10FFFF)
+    {
+        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
+        utf8_length = 4;
+        first_byte_mark = 0xF0; /* 11110000 */
+    }
+    else
+    {
+        /* invalid unicode codepoint */
+        goto fail;
+    }
+
+    /* encode as utf8 */
+    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    {
+        /* 10xxxxxx */
+        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
+        codepoint >>= 6;
+    }
+    /* encode first byte */
+    if (utf8_length > 1)
+    {
+        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+    }
+    else
+    {
+        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+    }
+
+    *output_pointer += utf8_length;
+
+    return sequence_length;
+
+fail:
+    return 0;
+}
+
+/* Parse the input text into an unescaped cinput, and populate item. */
+static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+{
+    const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
+    const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
+    const unsigned char * const buffer_end = input_buffer->content + input_buffer->length;
+    unsigned char *output_pointer = NULL;
+    unsigned char *output = NULL;
+
+    /* not a string */
+    if (buffer_at_offset(input_buffer)[0] != '\"')
+    {
+        goto fail;
+    }
+
+    {
+        /* calculate approximate size of the output (overestimate), jumping from one escape sequence to the next */
+        size_t allocation_length = 0;
+        size_t skipped_bytes = 0;
+        input_end = find_quote_or_backslash(input_end, buffer_end);
+        while ((input_end < buffer_end) && (*input_end == '\\'))
+        {
+            if ((input_end + 1) >= buffer_end)
+            {
+                /* prevent buffer overflow when last input character is a backslash */
+                goto fail;
+            }
+            skipped_bytes++;
+            input_end = find_quote_or_backslash(input_end + 2, buffer_end);
+        }
+        if (input_end >= buffer_end)
+        {
+            goto fail; /* string ended unexpectedly */
+        }
+
+        if (input_buffer->in_situ != NULL)
+        {
+            /* unescaping never makes a string longer, so the output can overwrite the input it was read from */
+            output = input_buffer->in_situ + (input_pointer - input_buffer->content);
+        }
+        else
+        {
+            /* This is at most how much we need for the output */
+            allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
+            output = (unsigned char*)allocate_with_hooks(&input_buffer->hooks, allocation_length + sizeof(""));
+            if (output == NULL)
+            {
+                goto fail; /* allocation failure */
+            }
+        }
+
+        /* without escape sequences the string is copied as it is, or stays where it is */
+        if (skipped_bytes == 0)
+        {
+            if (input_buffer->in_situ == NULL)
+            {
+                memcpy(output, input_pointer, (size_t)(input_end - input_pointer));
+            }
+            output_pointer = output + (input_end - input_pointer);
+            input_pointer = input_end;
+        }
+        else
+        {
+            output_pointer = output;
+        }
+    }
+
+    /* loop through the string literal */
+    while (input_pointer < input_end)
+    {
+        if (*input_pointer != '\\')
+        {
+            /* copy everything up to the next escape sequence at once; in place the two may overlap */
+            const unsigned char *run_end = find_quote_or_backslash(input_pointer + 1, input_end);
+            memmove(output_pointer, input_pointer, (size_t)(run_end - input_pointer));
+            output_pointer += run_end - input_pointer;
+            input_pointer = run_end;
+        }
+        /* escape sequence */
+        else
+        {
+            unsigned char sequence_length = 2;
+            if ((input_end - input_pointer) < 1)
+            {
+                goto fail;
+            }
+
+            switch (input_pointer[1])
+            {
+                case 'b':
+                    *output_pointer++ = '\b';
+                    break;
+                case 'f':
+                    *output_pointer++ = '\f';
+                    break;
+                case 'n':
+                    *output_pointer++ = '\n';
+                    break;
+                case 'r':
+                    *output_pointer++ = '\r';
+                    break;
+                case 't':
+                    *output_pointer++ = '\t';
+                    break;
+                case '\"':
+                case '\\':
+                case '/':
+                    *output_pointer++ = input_pointer[1];
+                    break;
+
+                /* UTF-16 literal */
+                case 'u':
+                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
+                    if (sequence_length == 0)
+                    {
+                        /* failed to convert UTF16-literal to UTF-8 */
+                        goto fail;
+                    }
+                    break;
+
+                default:
+                    goto fail;
+            }
+            input_pointer += sequence_length;
+        }
+    }
+
+    /* zero terminate the output */
+    *output_pointer = '\0';
+
+    item->type = cJSON_String;
+    if (input_buffer->in_situ != NULL)
+    {
+        /* the string lives in the caller's buffer and must not be freed with the item */
+        item->type |= cJSON_IsReference;
+    }
+    item->valuestring = (char*)output;
+
+    input_buffer->offset = (size_t) (input_end - input_buffer->content);
+    input_buffer->offset++;
+
+    return true;
+
+fail:
+    if ((output != NULL) && (input_buffer->in_situ == NULL))
+    {
+        deallocate_with_hooks(&input_buffer->hooks, output);
+    }
+
+    if (input_pointer != NULL)
+    {
+        input_buffer->offset = (size_t)(input_pointer - input_buffer->content);
+    }
+
+    return false;
+}
+
+/* Render the cstring provided to an escaped version that can be printed. */
+static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
+{
+    const unsigned char *input_pointer = NULL;
+    unsigned char *output = NULL;
+    unsigned char *output_pointer = NULL;
+    size_t output_length = 0;
+    /* numbers of additional characters needed for escaping */
+    size_t escape_characters = 0;
+
+    if (output_buffer == NULL)
+    {
+        return false;
+    }
+
+    /* empty string */
+    if (input == NULL)
+    {
+        output = ensure(output_buffer, sizeof("\"\""));
+        if (output == NULL)
+        {
+            return false;
+        }
+        strcpy((char*)output, "\"\"");
+
+        return true;
+    }
+
+    /* set "flag" to 1 if something needs to be escaped */
+    for (input_pointer = input; *input_pointer; input_pointer++)
+    {
+        switch (*input_pointer)
+        {
+            case '\"':
+            case '\\':
+            case '\b':
+            case '\f':
+            case '\n':
+            case '\r':
+            case '\t':
+                /* one character escape sequence */
+                escape_characters++;
+                break;
+            default:
+                if (*input_pointer < 32)
+                {
+                    /* UTF-16 escape sequence uXXXX */
+                    escape_characters += 5;
+                }
+                break;
+        }
+    }
+    output_length = (size_t)(input_pointer - input) + escape_characters;
+
+    output = ensure(output_buffer, output_length + sizeof("\"\""));
+    if (output == NULL)
+    {
+        return false;
+    }
+
+    /* no characters have to be escaped */
+    if (escape_characters == 0)
+    {
+        output[0] = '\"';
+        memcpy(output + 1, input, output_length);
+        output[output_length + 1] = '\"';
+        output[output_length + 2] = '\0';
+
+        return true;
+    }
+
+    output[0] = '\"';
+    output_pointer = output + 1;
+    /* copy the string */
+    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
+    {
+        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
+        {
+            /* normal character, copy */
+            *output_pointer = *input_pointer;
+        }
+        else
+        {
+            /* character needs to be escaped */
+            *output_pointer++ = '\\';
+            switch (*input_pointer)
+            {
+                case '\\':
+                    *output_pointer = '\\';
+                    break;
+                case '\"':
+                    *output_pointer = '\"';
+                    break;
+                case '\b':
+                    *output_pointer = 'b';
+                    break;
+                case '\f':
+                    *output_pointer = 'f';
+                    break;
+                case '\n':
+                    *output_pointer = 'n';
+                    break;
+                case '\r':
+                    *output_pointer = 'r';
+                    break;
+                case '\t':
+                    *output_pointer = 't';
+                    break;
+                default:
+                    /* escape and print as unicode codepoint */
+                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
+                    output_pointer += 4;
+                    break;
+            }
+        }
+    }
+    output[output_length + 1] = '\"';
+    output[output_length + 2] = '\0';
+
+    return true;
+}
+
+/* Invoke print_string_ptr (which is useful) on an item. */
+static cJSON_bool print_string(const cJSON * const item, printbuffer * const p)
+{
+    return print_string_ptr((unsigned char*)item->valuestring, p);
+}
+
+/* Predeclare these prototypes. */
+static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer);
+static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer);
+
+/* Utility to jump whitespace and cr/lf */
+static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL))
+    {
+        return NULL;
+    }
+
+    if (cannot_access_at_index(buffer, 0))
+    {
+        return buffer;
+    }
+
+    /* minified JSON has no whitespace at all */
+    if (buffer_at_offset(buffer)[0] > 32)
+    {
+        return buffer;
+    }
+
+    buffer->offset = (size_t)(skip_whitespace_run(buffer_at_offset(buffer), buffer->content + buffer->length) - buffer->content);
+
+    if (buffer->offset == buffer->length)
+    {
+        buffer->offset--;
+    }
+
+    return buffer;
+}
+
+/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
+static parse_buffer *skip_utf8_bom(parse_buffer * const buffer)
+{
+    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    {
+        return NULL;
+    }
+
+    if (can_access_at_index(buffer, 4) && (strncmp((const char*)buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    {
+        buffer->offset += 3;
+    }
+
+    return buffer;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    size_t buffer_length;
+
+    if (NULL == value)
+    {
+        return NULL;
+    }
+
+    /* Adding null character size due to require_null_terminated. */
+    buffer_length = strlen(value) + sizeof("");
+
+    return cJSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
+}
+
+/* Parse an object - create a new root, and populate. in_situ is value again, writable, for an in-situ parse and NULL otherwise.
+ * The error position goes to parse_error, which is global_error except for cJSON_ParseWithContext. */
+static cJSON *parse_with_hooks(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated, const internal_hooks * const hooks, char *in_situ, error * const parse_error)
+{
+    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0, 0, 0 }, NULL };
+    cJSON *item = NULL;
+
+    /* reset error position */
+    parse_error->json = NULL;
+    parse_error->position = 0;
+
+    if (value == NULL || 0 == buffer_length)
+    {
+        goto fail;
+    }
+
+    buffer.content = (const unsigned char*)value;
+    buffer.length = buffer_length;
+    buffer.offset = 0;
+    buffer.hooks = *hooks;
+    buffer.in_situ = (unsigned char*)in_situ;
+
+    item = cJSON_New_Item(hooks);
+    if (item == NULL) /* memory fail */
+    {
+        goto fail;
+    }
+
+    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(&buffer))))
+    {
+        /* parse failure. ep is set. */
+        goto fail;
+    }
+
+    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
+    if (require_null_terminated)
+    {
+        buffer_skip_whitespace(&buffer);
+        if ((buffer.offset >= buffer.length) || buffer_at_offset(&buffer)[0] != '\0')
+        {
+            goto fail;
+        }
+    }
+    if (return_parse_end)
+    {
+        *return_parse_end = (const char*)buffer_at_offset(&buffer);
+    }
+
+    return item;
+
+fail:
+    if (item != NULL)
+    {
+        delete_parsed(item, hooks);
+    }
+
+    if (value != NULL)
+    {
+        error local_error;
+        local_error.json = (const unsigned char*)value;
+        local_error.position = 0;
+
+        if (buffer.offset < buffer.length)
+        {
+            local_error.position = buffer.offset;
+        }
+        else if (buffer.length > 0)
+        {
+            local_error.position = buffer.length - 1;
+        }
+
+        if (return_parse_end != NULL)
+        {
+            *return_parse_end = (const char*)local_error.json + local_error.position;
+        }
+
+        *parse_error = local_error;
+    }
+
+    return NULL;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+{
+    return parse_with_hooks(value, buffer_length, return_parse_end, require_null_terminated, &global_hooks, NULL, &global_error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value, size_t buffer_length)
+{
+    return parse_with_hooks(value, buffer_length, NULL, false, &global_hooks, value, &global_error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(cJSON_ParseContext *context, const char *value, size_t buffer_length)
+{
+    internal_hooks hooks;
+    error parse_error;
+    cJSON *item = NULL;
+
+    if (context == NULL)
+    {
+        return NULL;
+    }
+    set_hooks(&hooks, &context->hooks);
+    hooks.arena = NULL;
+    hooks.pool = context->pool;
+
+    item = parse_with_hooks(value, buffer_length, NULL, false, &hooks, NULL, &parse_error);
+    context->error = NULL;
+    if ((item == NULL) && (parse_error.json != NULL))
+    {
+        context->error = (const char*)(parse_error.json + parse_error.position);
+    }
+
+    return item;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(const cJSON_ParseContext *context, cJSON *item)
+{
+    internal_hooks hooks;
+
+    if (context == NULL)
+    {
+        return;
+    }
+    set_hooks(&hooks, &context->hooks);
+    hooks.arena = NULL;
+    hooks.pool = context->pool;
+
+    delete_with_hooks(item, &hooks);
+}
+
+/* Default options for cJSON_Parse */
+CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+{
+    return cJSON_ParseWithOpts(value, 0, 0);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_length)
+{
+    return cJSON_ParseWithLengthOpts(value, buffer_length, 0, 0);
+}
+
+/* SAX parsing walks the input like parse_value and friends, but hands every value to the handler instead of building
+ * items. Strings are decoded by parse_string into a scratch arena that is rewound after each callback. */
+#define SAX_SCRATCH_BLOCK_SIZE 1024
+
+typedef struct
+{
+    parse_buffer buffer;
+    const cJSON_SAXHandler *handler;
+    void *context;
+} sax_parser;
+
+static cJSON_bool sax_parse_value(sax_parser * const parser);
+
+/* parse a string or key and report it */
+static cJSON_bool sax_parse_string(sax_parser * const parser, cJSON_bool (*callback)(void *context, const char *value))
+{
+    cJSON item;
+    cJSON_bool accepted = true;
+
+    memset(&item, '\0', sizeof(item));
+    if (!parse_string(&item, &parser->buffer))
+    {
+        return false;
+    }
+    if (callback != NULL)
+    {
+        accepted = callback(parser->context, item.valuestring);
+    }
+    cJSON_ResetArena(parser->buffer.hooks.arena);
+
+    return accepted;
+}
+
+static cJSON_bool sax_parse_array(sax_parser * const parser)
+{
+    parse_buffer * const input_buffer = &parser->buffer;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    if ((parser->handler->start_array != NULL) && !parser->handler->start_array(parser->context))
+    {
+        return false;
+    }
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
+    {
+        /* empty array */
+        goto success;
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    /* loop through the comma separated array elements */
+    do
+    {
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!sax_parse_value(parser))
+        {
+            return false; /* failed to parse value */
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || buffer_at_offset(input_buffer)[0] != ']')
+    {
+        return false; /* expected end of array */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return (parser->handler->end_array == NULL) || parser->handler->end_array(parser->context);
+}
+
+static cJSON_bool sax_parse_object(sax_parser * const parser)
+{
+    parse_buffer * const input_buffer = &parser->buffer;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    if ((parser->handler->start_object != NULL) && !parser->handler->start_object(parser->context))
+    {
+        return false;
+    }
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    {
+        goto success; /* empty object */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    /* loop through the comma separated object members */
+    do
+    {
+        /* parse the name of the child */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (cannot_access_at_index(input_buffer, 0) || !sax_parse_string(parser, parser->handler->key))
+        {
+            return false; /* failed to parse name */
+        }
+        buffer_skip_whitespace(input_buffer);
+
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+        {
+            return false; /* invalid object */
+        }
+
+        /* parse the value */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!sax_parse_value(parser))
+        {
+            return false; /* failed to parse value */
+        }
+        buffer_skip_whitespace(input_buffer);
+    }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
+
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    {
+        return false; /* expected end of object */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return (parser->handler->end_object == NULL) || parser->handler->end_object(parser->context);
+}
+
+static cJSON_bool sax_parse_value(sax_parser * const parser)
+{
+    parse_buffer * const input_buffer = &parser->buffer;
+    const cJSON_SAXHandler * const handler = parser->handler;
+
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    {
+        return false; /* no input */
+    }
+
+    /* null */
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
+    {
+        input_buffer->offset += 4;
+        return (handler->null == NULL) || handler->null(parser->context);
+    }
+    /* false */
+    if (can_read(input_buffer, 5) && (strncmp((const char*)buffer_at_offset(input_buffer), "false", 5) == 0))
+    {
+        input_buffer->offset += 5;
+        return (handler->boolean == NULL) || handler->boolean(parser->context, false);
+    }
+    /* true */
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "true", 4) == 0))
+    {
+        input_buffer->offset += 4;
+        return (handler->boolean == NULL) || handler->boolean(parser->context, true);
+    }
+    /* string */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '\"'))
+    {
+        return sax_parse_string(parser, handler->string);
+    }
+    /* number */
+    if (can_access_at_index(input_buffer, 0) && ((buffer_at_offset(input_buffer)[0] == '-') || ((buffer_at_offset(input_buffer)[0] >= '0') && (buffer_at_offset(input_buffer)[0] <= '9'))))
+    {
+        cJSON item;
+        memset(&item, '\0', sizeof(item));
+        if (!parse_number(&item, input_buffer))
+        {
+            return false;
+        }
+        return (handler->number == NULL) || handler->number(parser->context, item.valuedouble);
+    }
+    /* array */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '['))
+    {
+        return sax_parse_array(parser);
+    }
+    /* object */
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '{'))
+    {
+        return sax_parse_object(parser);
+    }
+
+    return false;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseSAX(const char *value, size_t buffer_length, const cJSON_SAXHandler *handler, void *context)
+{
+    sax_parser parser;
+    cJSON_Arena scratch;
+    cJSON_bool parsed = false;
+
+    /* reset error position */
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if ((value == NULL) || (buffer_length == 0) || (handler == NULL))
+    {
+        return false;
+    }
+
+    scratch.blocks = NULL;
+    scratch.block_size = SAX_SCRATCH_BLOCK_SIZE;
+    memset(&parser, '\0', sizeof(parser));
+    parser.buffer.content = (const unsigned char*)value;
+    parser.buffer.length = buffer_length;
+    parser.buffer.hooks = global_hooks;
+    parser.buffer.hooks.arena = &scratch;
+    parser.handler = handler;
+    parser.context = context;
+
+    parsed = (buffer_skip_whitespace(skip_utf8_bom(&parser.buffer)) != NULL) && sax_parse_value(&parser);
+    if (!parsed)
+    {
+        global_error.json = (const unsigned char*)value;
+        if (parser.buffer.offset < parser.buffer.length)
+        {
+            global_error.position = parser.buffer.offset;
+        }
+        else
+        {
+            global_error.position = parser.buffer.length - 1;
+        }
+    }
+
+    cJSON_ResetArena(&scratch);
+    if (scratch.blocks != NULL)
+    {
+        global_hooks.deallocate(scratch.blocks);
+    }
+
+    return parsed;
+}
+
+/* Stream parsing takes the input in chunks of any size and reports the same events as cJSON_ParseSAX.
+ * Instead of recursing it keeps the open containers on a stack and remembers where it stopped, so only
+ * a string, number or literal split between two chunks needs to be copied. */
+/* A parser lives as long as its download, often with many others in flight, so its scratch arena starts small */
+#define STREAM_SCRATCH_BLOCK_SIZE 256
+
+typedef enum
+{
+    stream_value,        /* a value must follow */
+    stream_value_or_end, /* after '[' */
+    stream_key,          /* after ',' in an object */
+    stream_key_or_end,   /* after '{' */
+    stream_colon,        /* after a key */
+    stream_comma_or_end, /* after a value inside a container */
+    stream_done,         /* the value is complete, whatever follows is ignored */
+    stream_failed
+} stream_state;
+
+typedef enum
+{
+    token_none,
+    token_string,
+    token_number,
+    token_literal
+} stream_token;
+
+struct cJSON_StreamParser
+{
+    const cJSON_SAXHandler *handler;
+    void *context;
+    internal_hooks hooks; /* strings are decoded into the scratch arena */
+    cJSON_Arena scratch;
+    stream_state state;
+    size_t bom_length; /* bytes of a leading UTF-8 BOM seen so far */
+    cJSON_bool started;
+    /* the token being read */
+    stream_token token;
+    cJSON_bool token_is_key;
+    cJSON_bool quote_seen;
+    cJSON_bool escaped; /* the previous character of the string was a backslash */
+    const char *literal; /* "true", "false" or "null" */
+    size_t literal_length; /* characters of the literal matched so far */
+    /* the part of a token that arrived in earlier chunks */
+    unsigned char *pending;
+    size_t pending_length;
+    size_t pending_size;
+    size_t depth;
+    unsigned char objects[(CJSON_NESTING_LIMIT + 7) / 8]; /* a bit per open container, set for objects */
+};
+
+#define stream_in_object(parser) ((((parser)->objects[((parser)->depth - 1) / 8]) & (1U << (((parser)->depth - 1) % 8))) != 0)
+
+static cJSON_bool stream_keep(cJSON_StreamParser * const parser, const unsigned char * const data, size_t length)
+{
+    if ((parser->pending_size - parser->pending_length) < length)
+    {
+        unsigned char *pending = NULL;
+        size_t new_size = (parser->pending_size == 0) ? 64 : parser->pending_size;
+
+        while ((new_size - parser->pending_length) < length)
+        {
+            if (new_size > ((size_t)-1 / 2))
+            {
+                return false;
+            }
+            new_size *= 2;
+        }
+        pending = (unsigned char*)parser->hooks.allocate(new_size);
+        if (pending == NULL)
+        {
+            return false;
+        }
+        if (parser->pending != NULL)
+        {
+            memcpy(pending, parser->pending, parser->pending_length);
+            parser->hooks.deallocate(parser->pending);
+        }
+        parser->pending = pending;
+        parser->pending_size = new_size;
+    }
+
+    memcpy(parser->pending + parser->pending_length, data, length);
+    parser->pending_length += length;
+
+    return true;
+}
+
+static void stream_value_complete(cJSON_StreamParser * const parser)
+{
+    parser->state = (parser->depth == 0) ? stream_done : stream_comma_or_end;
+}
+
+static cJSON_bool stream_open(cJSON_StreamParser * const parser, const unsigned char container)
+{
+    cJSON_bool (*callback)(void *context) = (container == '{') ? parser->handler->start_object : parser->handler->start_array;
+
+    if (parser->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    if (container == '{')
+    {
+        parser->objects[parser->depth / 8] = (unsigned char)(parser->objects[parser->depth / 8] | (1U << (parser->depth % 8)));
+    }
+    else
+    {
+        parser->objects[parser->depth / 8] = (unsigned char)(parser->objects[parser->depth / 8] & ~(1U << (parser->depth % 8)));
+    }
+    parser->depth++;
+    parser->state = (container == '{') ? stream_key_or_end : stream_value_or_end;
+
+    return (callback == NULL) || callback(parser->context);
+}
+
+static cJSON_bool stream_close(cJSON_StreamParser * const parser, const unsigned char end)
+{
+    cJSON_bool (*callback)(void *context) = NULL;
+
+    if ((parser->depth == 0) || (end != (stream_in_object(parser) ? '}' : ']')))
+    {
+        return false;
+    }
+    callback = (end == '}') ? parser->handler->end_object : parser->handler->end_array;
+    parser->depth--;
+    stream_value_complete(parser);
+
+    return (callback == NULL) || callback(parser->context);
+}
+
+/* decode the string at the start of text into the scratch arena, or return NULL if it is invalid or incomplete;
+ * length is the number of bytes available and becomes the length of the string with its quotes */
+static char *stream_decode_string(cJSON_StreamParser * const parser, const unsigned char * const text, size_t * const length)
+{
+    parse_buffer buffer;
+    cJSON item;
+
+    memset(&buffer, '\0', sizeof(buffer));
+    buffer.content = text;
+    buffer.length = *length;
+    buffer.hooks = parser->hooks;
+    memset(&item, '\0', sizeof(item));
+    if (!parse_string(&item, &buffer))
+    {
+        return NULL;
+    }
+    *length = buffer.offset;
+
+    return item.valuestring;
+}
+
+/* report a decoded string or key */
+static cJSON_bool stream_emit_string(cJSON_StreamParser * const parser, const char * const value)
+{
+    cJSON_bool (*callback)(void *context, const char *value) = parser->token_is_key ? parser->handler->key : parser->handler->string;
+    cJSON_bool accepted = true;
+
+    if (callback != NULL)
+    {
+        accepted = callback(parser->context, value);
+    }
+    cJSON_ResetArena(&parser->scratch);
+
+    if (parser->token_is_key)
+    {
+        parser->state = stream_colon;
+    }
+    else
+    {
+        stream_value_complete(parser);
+    }
+
+    return accepted;
+}
+
+/* decode a complete run of number characters */
+static cJSON_bool stream_emit_number(cJSON_StreamParser * const parser, const unsigned char * const text, size_t length)
+{
+    parse_buffer buffer;
+    cJSON item;
+
+    memset(&buffer, '\0', sizeof(buffer));
+    buffer.content = text;
+    buffer.length = length;
+    buffer.hooks = parser->hooks;
+    memset(&item, '\0', sizeof(item));
+    if (!parse_number(&item, &buffer))
+    {
+        return false;
+    }
+    /* characters parse_number left over can't follow a value inside a container, but trail a complete value at the top */
+    if ((buffer.offset < length) && (parser->depth > 0))
+    {
+        return false;
+    }
+    stream_value_complete(parser);
+
+    return (parser->handler->number == NULL) || parser->handler->number(parser->context, item.valuedouble);
+}
+
+/* read as much of the current token as the chunk holds, emitting it once it is complete */
+static cJSON_bool stream_read_token(cJSON_StreamParser * const parser, const unsigned char * const input, size_t length, size_t * const position)
+{
+    size_t start = *position;
+    size_t end = start;
+    cJSON_bool complete = false;
+    stream_token token = token_none;
+    const unsigned char *text = NULL;
+    size_t text_length = 0;
+
+    switch (parser->token)
+    {
+        case token_string:
+            if (!parser->quote_seen)
+            {
+                /* a string that ends inside this chunk is decoded in place instead of being scanned first */
+                size_t string_length = length - start;
+                char *value = stream_decode_string(parser, input + start, &string_length);
+                if (value != NULL)
+                {
+                    *position = start + string_length;
+                    parser->token = token_none;
+                    return stream_emit_string(parser, value);
+                }
+                parser->quote_seen = true;
+                end++;
+            }
+            while (end < length)
+            {
+                if (parser->escaped)
+                {
+                    parser->escaped = false;
+                    end++;
+                    continue;
+                }
+                end = (size_t)(find_quote_or_backslash(input + end, input + length) - input);
+                if (end == length)
+                {
+                    break;
+                }
+                if (input[end] == '\\')
+                {
+                    parser->escaped = true;
+                    end++;
+                    continue;
+                }
+                complete = true;
+                end++;
+                break;
+            }
+            break;
+
+        case token_number:
+            if (parser->pending_length == 0)
+            {
+                /* a number that ends inside this chunk is parsed in place instead of being scanned twice */
+                parse_buffer buffer;
+                cJSON item;
+
+                memset(&buffer, '\0', sizeof(buffer));
+                buffer.content = input + start;
+                buffer.length = length - start;
+                buffer.hooks = parser->hooks;
+                memset(&item, '\0', sizeof(item));
+                if (parse_number(&item, &buffer) && (buffer.offset < buffer.length) && !is_number_character(buffer.content[buffer.offset]))
+                {
+                    *position = start + buffer.offset;
+                    parser->token = token_none;
+                    stream_value_complete(parser);
+                    return (parser->handler->number == NULL) || parser->handler->number(parser->context, item.valuedouble);
+                }
+            }
+            while ((end < length) && is_number_character(input[end]))
+            {
+                end++;
+            }
+            complete = (end < length);
+            break;
+
+        case token_literal:
+            for (; (end < length) && (parser->literal[parser->literal_length] != '\0'); end++)
+            {
+                if (input[end] != (unsigned char)parser->literal[parser->literal_length])
+                {
+                    return false;
+                }
+                parser->literal_length++;
+            }
+            *position = end;
+            if (parser->literal[parser->literal_length] != '\0')
+            {
+                return true; /* the rest comes with the next chunk */
+            }
+            parser->token = token_none;
+            stream_value_complete(parser);
+            if (parser->literal[0] == 'n')
+            {
+                return (parser->handler->null == NULL) || parser->handler->null(parser->context);
+            }
+            return (parser->handler->boolean == NULL) || parser->handler->boolean(parser->context, parser->literal[0] == 't');
+
+        default:
+            return false;
+    }
+
+    *position = end;
+    if (!complete)
+    {
+        return stream_keep(parser, input + start, end - start);
+    }
+
+    token = parser->token;
+    parser->token = token_none;
+    parser->quote_seen = false;
+    if (parser->pending_length == 0)
+    {
+        /* the whole token is in this chunk */
+        text = input + start;
+        text_length = end - start;
+    }
+    else
+    {
+        if (!stream_keep(parser, input + start, end - start))
+        {
+            return false;
+        }
+        text = parser->pending;
+        text_length = parser->pending_length;
+        parser->pending_length = 0;
+    }
+
+    if (token == token_string)
+    {
+        char *value = stream_decode_string(parser, text, &text_length);
+        return (value != NULL) && stream_emit_string(parser, value);
+    }
+
+    return stream_emit_number(parser, text, text_length);
+}
+
+/* start the value beginning with character, or return false if none can */
+static cJSON_bool stream_start_value(cJSON_StreamParser * const parser, const unsigned char character, size_t * const position)
+{
+    switch (character)
+    {
+        case '{':
+        case '[':
+            (*position)++;
+            return stream_open(parser, character);
+
+        case '\"':
+            parser->token = token_string;
+            parser->token_is_key = false;
+            return true;
+
+        case 't':
+            parser->literal = "true";
+            break;
+
+        case 'f':
+            parser->literal = "false";
+            break;
+
+        case 'n':
+            parser->literal = "null";
+            break;
+
+        default:
+            if ((character == '-') || ((character >= '0') && (character <= '9')))
+            {
+                parser->token = token_number;
+                return true;
+            }
+            return false;
+    }
+
+    parser->token = token_literal;
+    parser->literal_length = 0;
+
+    return true;
+}
+
+static cJSON_bool stream_start_key(cJSON_StreamParser * const parser, const unsigned char character)
+{
+    if (character != '\"')
+    {
+        return false;
+    }
+    parser->token = token_string;
+    parser->token_is_key = true;
+
+    return true;
+}
+
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(const cJSON_SAXHandler *handler, void *context)
+{
+    cJSON_StreamParser *parser = NULL;
+
+    if (handler == NULL)
+    {
+        return NULL;
+    }
+
+    parser = (cJSON_StreamParser*)global_hooks.allocate(sizeof(cJSON_StreamParser));
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+    memset(parser, '\0', sizeof(cJSON_StreamParser));
+    parser->handler = handler;
+    parser->context = context;
+    parser->scratch.blocks = NULL;
+    parser->scratch.block_size = STREAM_SCRATCH_BLOCK_SIZE;
+    parser->hooks = global_hooks;
+    parser->hooks.arena = &parser->scratch;
+    parser->state = stream_value;
+    parser->token = token_none;
+    parser->literal = NULL;
+    parser->pending = NULL;
+
+    return parser;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_FeedStreamParser(cJSON_StreamParser *parser, const char *chunk, size_t length)
+{
+    static const unsigned char utf8_bom[] = { 0xEF, 0xBB, 0xBF };
+    const unsigned char *input = (const unsigned char*)chunk;
+    size_t position = 0;
+
+    if ((parser == NULL) || ((chunk == NULL) && (length > 0)) || (parser->state == stream_failed))
+    {
+        return false;
+    }
+
+    while ((position < length) && (parser->state != stream_done))
+    {
+        unsigned char character = 0;
+        cJSON_bool valid = true;
+
+        if (parser->token != token_none)
+        {
+            if (!stream_read_token(parser, input, length, &position))
+            {
+                goto fail;
+            }
+            continue;
+        }
+
+        character = input[position];
+        if (!parser->started)
+        {
+            /* skip a UTF-8 BOM, even one split between chunks */
+            if ((parser->bom_length < sizeof(utf8_bom)) && (character == utf8_bom[parser->bom_length]))
+            {
+                parser->bom_length++;
+                position++;
+                continue;
+            }
+            if ((parser->bom_length > 0) && (parser->bom_length < sizeof(utf8_bom)))
+            {
+                goto fail;
+            }
+            parser->started = true;
+        }
+
+        /* whitespace, as in buffer_skip_whitespace */
+        if (character <= 32)
+        {
+            position = (size_t)(skip_whitespace_run(input + position, input + length) - input);
+            continue;
+        }
+
+        switch (parser->state)
+        {
+            case stream_value_or_end:
+                if (character == ']')
+                {
+                    position++;
+                    valid = stream_close(parser, character);
+                }
+                else
+                {
+                    valid = stream_start_value(parser, character, &position);
+                }
+                break;
+
+            case stream_value:
+                valid = stream_start_value(parser, character, &position);
+                break;
+
+            case stream_key_or_end:
+                if (character == '}')
+                {
+                    position++;
+                    valid = stream_close(parser, character);
+                }
+                else
+                {
+                    valid = stream_start_key(parser, character);
+                }
+                break;
+
+            case stream_key:
+                valid = stream_start_key(parser, character);
+                break;
+
+            case stream_colon:
+                position++;
+                valid = (character == ':');
+                parser->state = stream_value;
+                break;
+
+            case stream_comma_or_end:
+                position++;
+                if (character == ',')
+                {
+                    parser->state = stream_in_object(parser) ? stream_key : stream_value;
+                }
+                else
+                {
+                    valid = ((character == '}') || (character == ']')) && stream_close(parser, character);
+                }
+                break;
+
+            default:
+                valid = false;
+                break;
+        }
+
+        if (!valid)
+        {
+            goto fail;
+        }
+    }
+
+    return true;
+
+fail:
+    parser->state = stream_failed;
+
+    return false;
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_FinishStreamParser(cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return false;
+    }
+
+    /* a number only ends with the input when nothing follows it */
+    if ((parser->state != stream_failed) && (parser->token == token_number))
+    {
+        size_t length = parser->pending_length;
+
+        parser->token = token_none;
+        parser->pending_length = 0;
+        if (!stream_emit_number(parser, parser->pending, length))
+        {
+            parser->state = stream_failed;
         }
-        else if ((input[i] >= 'a') && (input[i] <= 'f'))
+    }
+
+    return parser->state == stream_done;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser)
+{
+    if (parser == NULL)
+    {
+        return;
+    }
+
+    cJSON_ResetArena(&parser->scratch);
+    if (parser->scratch.blocks != NULL)
+    {
+        global_hooks.deallocate(parser->scratch.blocks);
+    }
+    if (parser->pending != NULL)
+    {
+        global_hooks.deallocate(parser->pending);
+    }
+    global_hooks.deallocate(parser);
+}
+
+/* Path extraction walks the input like cJSON_ParseSAX, but only decodes the values the paths lead to and skims
+ * everything else. A path follows the first member of each name, so it is settled (resolved or dead) as soon as
+ * that member has been read, and the walk stops once every path is. */
+typedef struct
+{
+    parse_buffer buffer;
+    cJSON_PathValue *values;
+    size_t path_count;
+    size_t unresolved; /* paths that are neither resolved nor dead */
+    const char *remaining[CJSON_PATH_LIMIT]; /* rest of each path after the names matched so far, NULL once it is settled */
+    size_t matched[CJSON_PATH_LIMIT]; /* how many names of each path were matched */
+} path_extractor;
+
+/* find the closing quote of the string at the current offset, NULL if it has none */
+static const unsigned char *path_string_end(const parse_buffer * const input_buffer)
+{
+    const unsigned char * const buffer_end = input_buffer->content + input_buffer->length;
+    const unsigned char *pointer = buffer_at_offset(input_buffer) + 1;
+
+    pointer = find_quote_or_backslash(pointer, buffer_end);
+    while ((pointer < buffer_end) && (*pointer == '\\'))
+    {
+        if ((pointer + 1) >= buffer_end)
         {
-            h += (unsigned int) 10 + input[i] - 'a';
+            return NULL;
         }
-        else /* invalid */
+        pointer = find_quote_or_backslash(pointer + 2, buffer_end);
+    }
+    if (pointer >= buffer_end)
+    {
+        return NULL; /* string ended unexpectedly */
+    }
+
+    return pointer;
+}
+
+/* decode one character or escape sequence of a string into unit, returns the number of bytes written (0 on failure) */
+static unsigned char path_decode_unit(const unsigned char ** const input_pointer, const unsigned char * const input_end, unsigned char * const unit)
+{
+    const unsigned char *pointer = *input_pointer;
+    unsigned char *output_pointer = unit;
+    unsigned char sequence_length = 2;
+
+    if (*pointer != '\\')
+    {
+        unit[0] = *pointer;
+        *input_pointer = pointer + 1;
+        return 1;
+    }
+    if ((input_end - pointer) < 2)
+    {
+        return 0;
+    }
+
+    switch (pointer[1])
+    {
+        case 'b':
+            *output_pointer++ = '\b';
+            break;
+        case 'f':
+            *output_pointer++ = '\f';
+            break;
+        case 'n':
+            *output_pointer++ = '\n';
+            break;
+        case 'r':
+            *output_pointer++ = '\r';
+            break;
+        case 't':
+            *output_pointer++ = '\t';
+            break;
+        case '\"':
+        case '\\':
+        case '/':
+            *output_pointer++ = pointer[1];
+            break;
+
+        /* UTF-16 literal */
+        case 'u':
+            sequence_length = utf16_literal_to_utf8(pointer, input_end, &output_pointer);
+            if (sequence_length == 0)
+            {
+                return 0;
+            }
+            break;
+
+        default:
+            return 0;
+    }
+    *input_pointer = pointer + sequence_length;
+
+    return (unsigned char)(output_pointer - unit);
+}
+
+/* compare a member name (without its quotes) with a path segment; escaped names are decoded on the fly */
+static cJSON_bool path_name_equals(const unsigned char *name, const unsigned char * const name_end, const char * const segment, const size_t segment_length)
+{
+    unsigned char unit[4];
+    unsigned char unit_length = 0;
+    size_t position = 0;
+
+    if (find_quote_or_backslash(name, name_end) == name_end)
+    {
+        return ((size_t)(name_end - name) == segment_length) && (memcmp(name, segment, segment_length) == 0);
+    }
+
+    while (name < name_end)
+    {
+        unit_length = path_decode_unit(&name, name_end, unit);
+        if ((unit_length == 0) || (unit[0] == '\0'))
+        {
+            break; /* an invalid name never matches, and a name ends at a decoded NUL like a cJSON key */
+        }
+        if (((segment_length - position) < unit_length) || (memcmp(unit, segment + position, unit_length) != 0))
+        {
+            return false;
+        }
+        position += unit_length;
+    }
+
+    return position == segment_length;
+}
+
+/* decode the string between start and end into a buffer of size bytes, truncating it at a character boundary */
+static cJSON_bool path_copy_string(const unsigned char *pointer, const unsigned char * const end, char * const buffer, const size_t size)
+{
+    unsigned char unit[4];
+    unsigned char unit_length = 0;
+    size_t used = 0;
+    cJSON_bool truncated = (buffer == NULL) || (size == 0);
+
+    while (pointer < end)
+    {
+        if (*pointer != '\\')
+        {
+            /* copy everything up to the next escape sequence at once */
+            const unsigned char *run_end = find_quote_or_backslash(pointer + 1, end);
+            size_t length = (size_t)(run_end - pointer);
+            if (!truncated)
+            {
+                if (length >= (size - used))
+                {
+                    length = size - used - 1;
+                    /* don't split a UTF-8 sequence */
+                    while ((length > 0) && ((pointer[length] & 0xC0) == 0x80))
+                    {
+                        length--;
+                    }
+                    truncated = true;
+                }
+                memcpy(buffer + used, pointer, length);
+                used += length;
+            }
+            pointer = run_end;
+        }
+        else
+        {
+            /* escape sequences are decoded even after truncation, so an invalid one is always noticed */
+            unit_length = path_decode_unit(&pointer, end, unit);
+            if (unit_length == 0)
+            {
+                return false;
+            }
+            if (!truncated)
+            {
+                if (unit_length >= (size - used))
+                {
+                    truncated = true;
+                }
+                else
+                {
+                    memcpy(buffer + used, unit, unit_length);
+                    used += unit_length;
+                }
+            }
+        }
+    }
+
+    if ((buffer != NULL) && (size > 0))
+    {
+        buffer[used] = '\0';
+    }
+
+    return true;
+}
+
+/* skip a value no path leads into: only strings are followed, and brackets must balance */
+static cJSON_bool path_skip_value(parse_buffer * const input_buffer)
+{
+    unsigned char objects[CJSON_NESTING_LIMIT / 8 + 1];
+    const unsigned char *string_end = NULL;
+    size_t depth = 0;
+    unsigned char character = 0;
+
+    do
+    {
+        if (cannot_access_at_index(input_buffer, 0))
+        {
+            return false;
+        }
+        character = buffer_at_offset(input_buffer)[0];
+        switch (character)
+        {
+            case '\"':
+                string_end = path_string_end(input_buffer);
+                if (string_end == NULL)
+                {
+                    return false;
+                }
+                input_buffer->offset = (size_t)(string_end - input_buffer->content) + 1;
+                break;
+
+            case '[':
+            case '{':
+                if ((input_buffer->depth + depth) >= CJSON_NESTING_LIMIT)
+                {
+                    return false; /* to deeply nested */
+                }
+                if (character == '{')
+                {
+                    objects[depth / 8] = (unsigned char)(objects[depth / 8] | (1U << (depth % 8)));
+                }
+                else
+                {
+                    objects[depth / 8] = (unsigned char)(objects[depth / 8] & ~(1U << (depth % 8)));
+                }
+                depth++;
+                input_buffer->offset++;
+                break;
+
+            case ']':
+            case '}':
+                if ((depth == 0) || (((objects[(depth - 1) / 8] & (1U << ((depth - 1) % 8))) != 0) != (character == '}')))
+                {
+                    return false; /* unbalanced brackets */
+                }
+                depth--;
+                input_buffer->offset++;
+                break;
+
+            case ',':
+            case ':':
+                if (depth == 0)
+                {
+                    return false;
+                }
+                input_buffer->offset++;
+                break;
+
+            default:
+                if (character <= 32)
+                {
+                    return false; /* whitespace is only left over at the end of the buffer */
+                }
+                /* a number or a literal runs up to the next structural character or whitespace */
+                while (can_access_at_index(input_buffer, 0))
+                {
+                    character = buffer_at_offset(input_buffer)[0];
+                    if ((character <= 32) || (character == ',') || (character == ':') || (character == '\"')
+                        || (character == '[') || (character == ']') || (character == '{') || (character == '}'))
+                    {
+                        break;
+                    }
+                    input_buffer->offset++;
+                }
+                break;
+        }
+        if (depth > 0)
+        {
+            buffer_skip_whitespace(input_buffer);
+        }
+    }
+    while (depth > 0);
+
+    return true;
+}
+
+/* hand the value at the current offset to every path that ends here and mark them resolved */
+static void path_resolve(path_extractor * const extractor, const size_t level, const cJSON * const item, const unsigned char * const string, const unsigned char * const string_end)
+{
+    size_t index = 0;
+
+    for (index = 0; index < extractor->path_count; index++)
+    {
+        if ((extractor->remaining[index] != NULL) && (extractor->matched[index] == level) && (extractor->remaining[index][0] == '\0'))
+        {
+            cJSON_PathValue * const value = &extractor->values[index];
+            value->type = item->type;
+            value->valueint = item->valueint;
+            value->valuedouble = item->valuedouble;
+            if (item->type == cJSON_String)
+            {
+                /* already validated by the caller */
+                path_copy_string(string, string_end, value->valuestring, value->valuestring_size);
+            }
+            extractor->remaining[index] = NULL;
+            extractor->unresolved--;
+        }
+    }
+}
+
+/* read a value that paths end at */
+static cJSON_bool path_read_value(path_extractor * const extractor, const size_t level)
+{
+    parse_buffer * const input_buffer = &extractor->buffer;
+    const unsigned char *string = NULL;
+    const unsigned char *string_end = NULL;
+    cJSON item;
+
+    memset(&item, '\0', sizeof(item));
+
+    /* null */
+    if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
+    {
+        item.type = cJSON_NULL;
+        input_buffer->offset += 4;
+    }
+    /* false */
+    else if (can_read(input_buffer, 5) && (strncmp((const char*)buffer_at_offset(input_buffer), "false", 5) == 0))
+    {
+        item.type = cJSON_False;
+        input_buffer->offset += 5;
+    }
+    /* true */
+    else if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "true", 4) == 0))
+    {
+        item.type = cJSON_True;
+        item.valueint = 1;
+        input_buffer->offset += 4;
+    }
+    /* string */
+    else if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '\"'))
+    {
+        string = buffer_at_offset(input_buffer) + 1;
+        string_end = path_string_end(input_buffer);
+        if ((string_end == NULL) || !path_copy_string(string, string_end, NULL, 0))
+        {
+            return false;
+        }
+        item.type = cJSON_String;
+        input_buffer->offset = (size_t)(string_end - input_buffer->content) + 1;
+    }
+    /* number */
+    else if (can_access_at_index(input_buffer, 0) && ((buffer_at_offset(input_buffer)[0] == '-') || ((buffer_at_offset(input_buffer)[0] >= '0') && (buffer_at_offset(input_buffer)[0] <= '9'))))
+    {
+        if (!parse_number(&item, input_buffer))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        return false;
+    }
+
+    path_resolve(extractor, level, &item, string, string_end);
+
+    return true;
+}
+
+static cJSON_bool path_extract_value(path_extractor * const extractor, const size_t level);
+
+/* walk an object some paths lead into, matching its names against their next segment */
+static cJSON_bool path_extract_object(path_extractor * const extractor, const size_t level)
+{
+    parse_buffer * const input_buffer = &extractor->buffer;
+    const unsigned char *name = NULL;
+    const unsigned char *name_end = NULL;
+    size_t index = 0;
+
+    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
+    {
+        return false; /* to deeply nested */
+    }
+    input_buffer->depth++;
+
+    input_buffer->offset++;
+    buffer_skip_whitespace(input_buffer);
+    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    {
+        goto success; /* empty object */
+    }
+
+    /* check if we skipped to the end of the buffer */
+    if (cannot_access_at_index(input_buffer, 0))
+    {
+        input_buffer->offset--;
+        return false;
+    }
+
+    /* step back to character in front of the first element */
+    input_buffer->offset--;
+    /* loop through the comma separated object members */
+    do
+    {
+        cJSON_bool followed = false;
+
+        /* read the name of the child */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '\"'))
+        {
+            return false; /* failed to parse name */
+        }
+        name = buffer_at_offset(input_buffer) + 1;
+        name_end = path_string_end(input_buffer);
+        if (name_end == NULL)
+        {
+            return false; /* failed to parse name */
+        }
+        input_buffer->offset = (size_t)(name_end - input_buffer->content) + 1;
+
+        /* let every open path whose next segment is this name follow it */
+        for (index = 0; index < extractor->path_count; index++)
+        {
+            const char *segment = extractor->remaining[index];
+            const char *segment_end = NULL;
+            if ((segment == NULL) || (extractor->matched[index] != level) || (segment[0] == '\0'))
+            {
+                continue;
+            }
+            if ((name < name_end) && (name[0] != '\\') && (name[0] != (unsigned char)segment[0]))
+            {
+                continue; /* cheap mismatch on the first character */
+            }
+            segment_end = strchr(segment, '/');
+            if (segment_end == NULL)
+            {
+                segment_end = segment + strlen(segment);
+            }
+            if (path_name_equals(name, name_end, segment, (size_t)(segment_end - segment)))
+            {
+                extractor->remaining[index] = (segment_end[0] == '/') ? (segment_end + 1) : segment_end;
+                extractor->matched[index] = level + 1;
+                followed = true;
+            }
+        }
+
+        buffer_skip_whitespace(input_buffer);
+        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+        {
+            return false; /* invalid object */
+        }
+
+        /* read or skip the value */
+        input_buffer->offset++;
+        buffer_skip_whitespace(input_buffer);
+        if (!path_extract_value(extractor, level + 1))
         {
-            return 0;
+            return false; /* failed to parse value */
         }
 
-        if (i < 3)
+        if (followed)
         {
-            /* shift left to make place for the next nibble */
-            h = h << 4;
+            /* paths that went into this member and found nothing there are dead, later members of the same name don't count */
+            for (index = 0; index < extractor->path_count; index++)
+            {
+                if ((extractor->remaining[index] != NULL) && (extractor->matched[index] > level))
+                {
+                    extractor->remaining[index] = NULL;
+                    extractor->unresolved--;
+                }
+            }
+            if (extractor->unresolved == 0)
+            {
+                return true; /* nothing left to look for */
+            }
         }
+        buffer_skip_whitespace(input_buffer);
     }
+    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
 
-    return h;
+    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    {
+        return false; /* expected end of object */
+    }
+
+success:
+    input_buffer->depth--;
+    input_buffer->offset++;
+
+    return true;
 }
 
-/* converts a UTF-16 literal to UTF-8
- * A literal can be one or two sequences of the form \uXXXX */
-static unsigned char utf16_literal_to_utf8(const unsigned char * const input_pointer, const unsigned char * const input_end, unsigned char **output_pointer)
+static cJSON_bool path_extract_value(path_extractor * const extractor, const size_t level)
 {
-    long unsigned int codepoint = 0;
-    unsigned int first_code = 0;
-    const unsigned char *first_sequence = input_pointer;
-    unsigned char utf8_length = 0;
-    unsigned char utf8_position = 0;
-    unsigned char sequence_length = 0;
-    unsigned char first_byte_mark = 0;
+    parse_buffer * const input_buffer = &extractor->buffer;
+    cJSON_bool ends_here = false;
+    cJSON_bool leads_inside = false;
+    size_t index = 0;
 
-    if ((input_end - first_sequence) < 6)
+    for (index = 0; index < extractor->path_count; index++)
     {
-        /* input ends unexpectedly */
-        goto fail;
+        if ((extractor->remaining[index] != NULL) && (extractor->matched[index] == level))
+        {
+            if (extractor->remaining[index][0] == '\0')
+            {
+                ends_here = true;
+            }
+            else
+            {
+                leads_inside = true;
+            }
+        }
     }
-
-    /* get the first utf16 sequence */
-    first_code = parse_hex4(first_sequence + 2);
-
-    /* check that the code is valid */
-    if (((first_code >= 0xDC00) && (first_code <= 0xDFFF)))
+    if (cannot_access_at_index(input_buffer, 0))
     {
-        goto fail;
+        return false;
     }
 
-    /* UTF16 surrogate pair */
-    if ((first_code >= 0xD800) && (first_code <= 0xDBFF))
+    if (ends_here)
     {
-        const unsigned char *second_sequence = first_sequence + 6;
-        unsigned int second_code = 0;
-        sequence_length = 12; /* \uXXXX\uXXXX */
-
-        if ((input_end - second_sequence) < 6)
+        if ((buffer_at_offset(input_buffer)[0] != '{') && (buffer_at_offset(input_buffer)[0] != '['))
         {
-            /* input ends unexpectedly */
-            goto fail;
+            return path_read_value(extractor, level);
         }
 
-        if ((second_sequence[0] != '\\') || (second_sequence[1] != 'u'))
         {
-            /* missing second half of the surrogate pair */
-            goto fail;
+            /* a container is reported by its type only */
+            cJSON item;
+            memset(&item, '\0', sizeof(item));
+            item.type = (buffer_at_offset(input_buffer)[0] == '{') ? cJSON_Object : cJSON_Array;
+            path_resolve(extractor, level, &item, NULL, NULL);
         }
-
-        /* get the second utf16 sequence */
-        second_code = parse_hex4(second_sequence + 2);
-        /* check that the code is valid */
-        if ((second_code < 0xDC00) || (second_code > 0xDFFF))
+        if (extractor->unresolved == 0)
         {
-            /* invalid second half of the surrogate pair */
-            goto fail;
+            return true;
         }
-
-
-        /* calculate the unicode codepoint from the surrogate pair */
-        codepoint = 0x10000 + (((first_code & 0x3FF) << 10) | (second_code & 0x3FF));
-    }
-    else
-    {
-        sequence_length = 6; /* \uXXXX */
-        codepoint = first_code;
     }
 
-    /* encode as UTF-8
-     * takes at maximum 4 bytes to encode:
-     * 11110xxx 10xxxxxx 10xxxxxx 10xxxxxx */
-    if (codepoint < 0x80)
-    {
-        /* normal ascii, encoding 0xxxxxxx */
-        utf8_length = 1;
-    }
-    else if (codepoint < 0x800)
-    {
-        /* two bytes, encoding 110xxxxx 10xxxxxx */
-        utf8_length = 2;
-        first_byte_mark = 0xC0; /* 11000000 */
-    }
-    else if (codepoint < 0x10000)
-    {
-        /* three bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 3;
-        first_byte_mark = 0xE0; /* 11100000 */
-    }
-    else if (codepoint <= 0x10FFFF)
-    {
-        /* four bytes, encoding 1110xxxx 10xxxxxx 10xxxxxx 10xxxxxx */
-        utf8_length = 4;
-        first_byte_mark = 0xF0; /* 11110000 */
-    }
-    else
+    if (leads_inside && (buffer_at_offset(input_buffer)[0] == '{'))
     {
-        /* invalid unicode codepoint */
-        goto fail;
+        return path_extract_object(extractor, level);
     }
 
-    /* encode as utf8 */
-    for (utf8_position = (unsigned char)(utf8_length - 1); utf8_position > 0; utf8_position--)
+    return path_skip_value(input_buffer);
+}
+
+CJSON_PUBLIC(cJSON_bool) cJSON_ExtractPaths(const char *value, size_t buffer_length, const char * const *paths, size_t path_count, cJSON_PathValue *values)
+{
+    path_extractor extractor;
+    cJSON_bool extracted = false;
+    size_t index = 0;
+
+    /* reset error position */
+    global_error.json = NULL;
+    global_error.position = 0;
+
+    if ((value == NULL) || (buffer_length == 0) || (path_count > CJSON_PATH_LIMIT) || ((path_count > 0) && ((paths == NULL) || (values == NULL))))
     {
-        /* 10xxxxxx */
-        (*output_pointer)[utf8_position] = (unsigned char)((codepoint | 0x80) & 0xBF);
-        codepoint >>= 6;
+        return false;
     }
-    /* encode first byte */
-    if (utf8_length > 1)
+
+    memset(&extractor, '\0', sizeof(extractor));
+    for (index = 0; index < path_count; index++)
     {
-        (*output_pointer)[0] = (unsigned char)((codepoint | first_byte_mark) & 0xFF);
+        if (paths[index] == NULL)
+        {
+            return false;
+        }
+        extractor.remaining[index] = paths[index];
+        values[index].type = cJSON_Invalid;
+        values[index].valueint = 0;
+        values[index].valuedouble = 0;
+        if ((values[index].valuestring != NULL) && (values[index].valuestring_size > 0))
+        {
+            values[index].valuestring[0] = '\0';
+        }
     }
-    else
+    extractor.values = values;
+    extractor.path_count = path_count;
+    extractor.unresolved = path_count;
+    extractor.buffer.content = (const unsigned char*)value;
+    extractor.buffer.length = buffer_length;
+    extractor.buffer.hooks = global_hooks;
+
+    extracted = (buffer_skip_whitespace(skip_utf8_bom(&extractor.buffer)) != NULL) && path_extract_value(&extractor, 0);
+    if (!extracted)
     {
-        (*output_pointer)[0] = (unsigned char)(codepoint & 0x7F);
+        global_error.json = (const unsigned char*)value;
+        if (extractor.buffer.offset < extractor.buffer.length)
+        {
+            global_error.position = extractor.buffer.offset;
+        }
+        else
+        {
+            global_error.position = extractor.buffer.length - 1;
+        }
     }
 
-    *output_pointer += utf8_length;
+    return extracted;
+}
 
-    return sequence_length;
+/* A tape stores a document as one array of entries in document order plus one buffer of NUL-terminated strings.
+ * It is built from the events of cJSON_ParseSAX, so it accepts exactly what the other parsers accept. */
+#define TAPE_END (cJSON_Raw << 1) /* closes an object or array, the payload is its number of values */
+#define TAPE_NAME (cJSON_Raw << 2) /* name of the object member that follows, the payload is its offset in strings */
 
-fail:
-    return 0;
-}
+/* An entry is a type with a 32 bit payload, or the value of the cJSON_Number entry in front of it.
+ * Objects and arrays point past their TAPE_END, so skipping one takes one step; strings point into the string buffer. */
+typedef union
+{
+    struct
+    {
+        unsigned int type;
+        unsigned int payload;
+    } tag;
+    double number;
+} tape_entry;
 
-/* Parse the input text into an unescaped cinput, and populate item. */
-static cJSON_bool parse_string(cJSON * const item, parse_buffer * const input_buffer)
+struct cJSON_Tape
 {
-    const unsigned char *input_pointer = buffer_at_offset(input_buffer) + 1;
-    const unsigned char *input_end = buffer_at_offset(input_buffer) + 1;
-    unsigned char *output_pointer = NULL;
-    unsigned char *output = NULL;
+    tape_entry *entries;
+    size_t count;
+    char *strings;
+    size_t strings_length;
+};
 
-    /* not a string */
-    if (buffer_at_offset(input_buffer)[0] != '\"')
-    {
-        goto fail;
-    }
+typedef struct
+{
+    cJSON_Tape *tape;
+    size_t entries_size; /* bytes allocated for tape->entries */
+    size_t strings_size; /* bytes allocated for tape->strings */
+    size_t depth;
+    size_t open[CJSON_NESTING_LIMIT]; /* entry of every open object or array */
+    size_t counts[CJSON_NESTING_LIMIT]; /* values it has so far */
+} tape_builder;
+
+/* grow a block to hold at least needed bytes, keeping the first used ones; returns NULL and leaves it alone on failure */
+static void *tape_grow(void *block, const size_t used, size_t * const size, const size_t needed)
+{
+    void *grown = NULL;
+    size_t new_size = (*size == 0) ? 64 : *size;
 
+    while (new_size < needed)
     {
-        /* calculate approximate size of the output (overestimate) */
-        size_t allocation_length = 0;
-        size_t skipped_bytes = 0;
-        while (((size_t)(input_end - input_buffer->content) < input_buffer->length) && (*input_end != '\"'))
-        {
-            /* is escape sequence */
-            if (input_end[0] == '\\')
-            {
-                if ((size_t)(input_end + 1 - input_buffer->content) >= input_buffer->length)
-                {
-                    /* prevent buffer overflow when last input character is a backslash */
-                    goto fail;
-                }
-                skipped_bytes++;
-                input_end++;
-            }
-            input_end++;
-        }
-        if (((size_t)(input_end - input_buffer->content) >= input_buffer->length) || (*input_end != '\"'))
+        if (new_size > ((size_t)-1 / 2))
         {
-            goto fail; /* string ended unexpectedly */
+            return NULL;
         }
+        new_size *= 2;
+    }
 
-        /* This is at most how much we need for the output */
-        allocation_length = (size_t) (input_end - buffer_at_offset(input_buffer)) - skipped_bytes;
-        output = (unsigned char*)input_buffer->hooks.allocate(allocation_length + sizeof(""));
-        if (output == NULL)
+    if (global_hooks.reallocate != NULL)
+    {
+        grown = global_hooks.reallocate(block, new_size);
+        if (grown == NULL)
         {
-            goto fail; /* allocation failure */
+            return NULL;
         }
     }
-
-    output_pointer = output;
-    /* loop through the string literal */
-    while (input_pointer < input_end)
+    else
     {
-        if (*input_pointer != '\\')
+        grown = global_hooks.allocate(new_size);
+        if (grown == NULL)
         {
-            *output_pointer++ = *input_pointer++;
+            return NULL;
         }
-        /* escape sequence */
-        else
+        if (block != NULL)
         {
-            unsigned char sequence_length = 2;
-            if ((input_end - input_pointer) < 1)
-            {
-                goto fail;
-            }
-
-            switch (input_pointer[1])
-            {
-                case 'b':
-                    *output_pointer++ = '\b';
-                    break;
-                case 'f':
-                    *output_pointer++ = '\f';
-                    break;
-                case 'n':
-                    *output_pointer++ = '\n';
-                    break;
-                case 'r':
-                    *output_pointer++ = '\r';
-                    break;
-                case 't':
-                    *output_pointer++ = '\t';
-                    break;
-                case '\"':
-                case '\\':
-                case '/':
-                    *output_pointer++ = input_pointer[1];
-                    break;
-
-                /* UTF-16 literal */
-                case 'u':
-                    sequence_length = utf16_literal_to_utf8(input_pointer, input_end, &output_pointer);
-                    if (sequence_length == 0)
-                    {
-                        /* failed to convert UTF16-literal to UTF-8 */
-                        goto fail;
-                    }
-                    break;
-
-                default:
-                    goto fail;
-            }
-            input_pointer += sequence_length;
+            memcpy(grown, block, used);
+            global_hooks.deallocate(block);
         }
     }
+    *size = new_size;
 
-    /* zero terminate the output */
-    *output_pointer = '\0';
-
-    item->type = cJSON_String;
-    item->valuestring = (char*)output;
-
-    input_buffer->offset = (size_t) (input_end - input_buffer->content);
-    input_buffer->offset++;
+    return grown;
+}
 
-    return true;
+/* make room for one more entry */
+static cJSON_bool tape_reserve(tape_builder * const builder)
+{
+    cJSON_Tape * const tape = builder->tape;
+    tape_entry *entries = NULL;
 
-fail:
-    if (output != NULL)
+    if (tape->count >= UINT_MAX)
     {
-        input_buffer->hooks.deallocate(output);
+        return false; /* entries are addressed with 32 bit payloads */
     }
-
-    if (input_pointer != NULL)
+    if (((tape->count + 1) * sizeof(tape_entry)) <= builder->entries_size)
     {
-        input_buffer->offset = (size_t)(input_pointer - input_buffer->content);
+        return true;
+    }
+    entries = (tape_entry*)tape_grow(tape->entries, tape->count * sizeof(tape_entry), &builder->entries_size, (tape->count + 1) * sizeof(tape_entry));
+    if (entries == NULL)
+    {
+        return false;
     }
+    tape->entries = entries;
 
-    return false;
+    return true;
 }
 
-/* Render the cstring provided to an escaped version that can be printed. */
-static cJSON_bool print_string_ptr(const unsigned char * const input, printbuffer * const output_buffer)
+static cJSON_bool tape_append(tape_builder * const builder, const unsigned int type, const size_t payload)
 {
-    const unsigned char *input_pointer = NULL;
-    unsigned char *output = NULL;
-    unsigned char *output_pointer = NULL;
-    size_t output_length = 0;
-    /* numbers of additional characters needed for escaping */
-    size_t escape_characters = 0;
+    cJSON_Tape * const tape = builder->tape;
 
-    if (output_buffer == NULL)
+    if ((payload > UINT_MAX) || !tape_reserve(builder))
     {
         return false;
     }
+    tape->entries[tape->count].tag.type = type;
+    tape->entries[tape->count].tag.payload = (unsigned int)payload;
+    tape->count++;
 
-    /* empty string */
-    if (input == NULL)
+    return true;
+}
+
+static cJSON_bool tape_append_string(tape_builder * const builder, const unsigned int type, const char * const value)
+{
+    cJSON_Tape * const tape = builder->tape;
+    const size_t offset = tape->strings_length;
+    const size_t length = strlen(value) + sizeof("");
+
+    if ((builder->strings_size - offset) < length)
     {
-        output = ensure(output_buffer, sizeof("\"\""));
-        if (output == NULL)
+        char *strings = (char*)tape_grow(tape->strings, offset, &builder->strings_size, offset + length);
+        if (strings == NULL)
         {
             return false;
         }
-        strcpy((char*)output, "\"\"");
-
-        return true;
+        tape->strings = strings;
     }
+    memcpy(tape->strings + offset, value, length);
+    tape->strings_length += length;
 
-    /* set "flag" to 1 if something needs to be escaped */
-    for (input_pointer = input; *input_pointer; input_pointer++)
+    return tape_append(builder, type, offset);
+}
+
+/* count a value towards the object or array it is in */
+static void tape_count_value(tape_builder * const builder)
+{
+    if (builder->depth > 0)
     {
-        switch (*input_pointer)
-        {
-            case '\"':
-            case '\\':
-            case '\b':
-            case '\f':
-            case '\n':
-            case '\r':
-            case '\t':
-                /* one character escape sequence */
-                escape_characters++;
-                break;
-            default:
-                if (*input_pointer < 32)
-                {
-                    /* UTF-16 escape sequence uXXXX */
-                    escape_characters += 5;
-                }
-                break;
-        }
+        builder->counts[builder->depth - 1]++;
     }
-    output_length = (size_t)(input_pointer - input) + escape_characters;
+}
 
-    output = ensure(output_buffer, output_length + sizeof("\"\""));
-    if (output == NULL)
+static cJSON_bool tape_start_container(tape_builder * const builder, const unsigned int type)
+{
+    if (builder->depth >= CJSON_NESTING_LIMIT)
     {
         return false;
     }
+    tape_count_value(builder);
+    builder->open[builder->depth] = builder->tape->count;
+    builder->counts[builder->depth] = 0;
+    builder->depth++;
 
-    /* no characters have to be escaped */
-    if (escape_characters == 0)
-    {
-        output[0] = '\"';
-        memcpy(output + 1, input, output_length);
-        output[output_length + 1] = '\"';
-        output[output_length + 2] = '\0';
+    return tape_append(builder, type, 0);
+}
 
-        return true;
+static cJSON_bool tape_start_object(void *context)
+{
+    return tape_start_container((tape_builder*)context, cJSON_Object);
+}
+
+static cJSON_bool tape_start_array(void *context)
+{
+    return tape_start_container((tape_builder*)context, cJSON_Array);
+}
+
+static cJSON_bool tape_end_container(void *context)
+{
+    tape_builder * const builder = (tape_builder*)context;
+    cJSON_Tape * const tape = builder->tape;
+
+    builder->depth--;
+    if (!tape_append(builder, TAPE_END, builder->counts[builder->depth]))
+    {
+        return false;
     }
+    /* tape_reserve keeps count within 32 bits */
+    tape->entries[builder->open[builder->depth]].tag.payload = (unsigned int)tape->count;
 
-    output[0] = '\"';
-    output_pointer = output + 1;
-    /* copy the string */
-    for (input_pointer = input; *input_pointer != '\0'; (void)input_pointer++, output_pointer++)
+    return true;
+}
+
+static cJSON_bool tape_name(void *context, const char *name)
+{
+    return tape_append_string((tape_builder*)context, TAPE_NAME, name);
+}
+
+static cJSON_bool tape_string(void *context, const char *value)
+{
+    tape_count_value((tape_builder*)context);
+    return tape_append_string((tape_builder*)context, cJSON_String, value);
+}
+
+static cJSON_bool tape_number(void *context, double value)
+{
+    tape_builder * const builder = (tape_builder*)context;
+
+    tape_count_value(builder);
+    if (!tape_append(builder, cJSON_Number, 0) || !tape_reserve(builder))
     {
-        if ((*input_pointer > 31) && (*input_pointer != '\"') && (*input_pointer != '\\'))
-        {
-            /* normal character, copy */
-            *output_pointer = *input_pointer;
-        }
-        else
-        {
-            /* character needs to be escaped */
-            *output_pointer++ = '\\';
-            switch (*input_pointer)
-            {
-                case '\\':
-                    *output_pointer = '\\';
-                    break;
-                case '\"':
-                    *output_pointer = '\"';
-                    break;
-                case '\b':
-                    *output_pointer = 'b';
-                    break;
-                case '\f':
-                    *output_pointer = 'f';
-                    break;
-                case '\n':
-                    *output_pointer = 'n';
-                    break;
-                case '\r':
-                    *output_pointer = 'r';
-                    break;
-                case '\t':
-                    *output_pointer = 't';
-                    break;
-                default:
-                    /* escape and print as unicode codepoint */
-                    sprintf((char*)output_pointer, "u%04x", *input_pointer);
-                    output_pointer += 4;
-                    break;
-            }
-        }
+        return false;
     }
-    output[output_length + 1] = '\"';
-    output[output_length + 2] = '\0';
+    builder->tape->entries[builder->tape->count].number = value;
+    builder->tape->count++;
 
     return true;
 }
 
-/* Invoke print_string_ptr (which is useful) on an item. */
-static cJSON_bool print_string(const cJSON * const item, printbuffer * const p)
+static cJSON_bool tape_boolean(void *context, cJSON_bool value)
 {
-    return print_string_ptr((unsigned char*)item->valuestring, p);
+    tape_count_value((tape_builder*)context);
+    return tape_append((tape_builder*)context, value ? cJSON_True : cJSON_False, 0);
 }
 
-/* Predeclare these prototypes. */
-static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer);
-static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer);
-static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer);
-static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer);
+static cJSON_bool tape_null(void *context)
+{
+    tape_count_value((tape_builder*)context);
+    return tape_append((tape_builder*)context, cJSON_NULL, 0);
+}
 
-/* Utility to jump whitespace and cr/lf */
-static parse_buffer *buffer_skip_whitespace(parse_buffer * const buffer)
+static const cJSON_SAXHandler tape_handler = {
+    tape_start_object, tape_end_container, tape_start_array, tape_end_container,
+    tape_name, tape_string, tape_number, tape_boolean, tape_null
+};
+
+CJSON_PUBLIC(cJSON_Tape *) cJSON_ParseTape(const char *value, size_t buffer_length)
 {
-    if ((buffer == NULL) || (buffer->content == NULL))
+    tape_builder *builder = NULL;
+    cJSON_Tape *tape = NULL;
+    cJSON_bool parsed = false;
+
+    builder = (tape_builder*)global_hooks.allocate(sizeof(tape_builder));
+    tape = (cJSON_Tape*)global_hooks.allocate(sizeof(cJSON_Tape));
+    if ((builder == NULL) || (tape == NULL))
     {
-        return NULL;
+        goto fail;
     }
+    memset(tape, '\0', sizeof(cJSON_Tape));
+    builder->tape = tape;
+    builder->entries_size = 0;
+    builder->strings_size = 0;
+    builder->depth = 0;
 
-    if (cannot_access_at_index(buffer, 0))
+    /* start with room for a typical document of this size, so only unusually dense ones need to grow */
+    tape->entries = (tape_entry*)tape_grow(NULL, 0, &builder->entries_size, buffer_length);
+    tape->strings = (char*)tape_grow(NULL, 0, &builder->strings_size, buffer_length / 4);
+    if ((tape->entries == NULL) || (tape->strings == NULL))
     {
-        return buffer;
+        goto fail;
     }
 
-    while (can_access_at_index(buffer, 0) && (buffer_at_offset(buffer)[0] <= 32))
+    parsed = cJSON_ParseSAX(value, buffer_length, &tape_handler, builder);
+    if (!parsed)
     {
-       buffer->offset++;
+        goto fail;
     }
 
-    if (buffer->offset == buffer->length)
+    /* give back what the estimate left unused */
+    if (global_hooks.reallocate != NULL)
     {
-        buffer->offset--;
+        tape_entry *entries = (tape_entry*)global_hooks.reallocate(tape->entries, tape->count * sizeof(tape_entry));
+        char *strings = (char*)global_hooks.reallocate(tape->strings, (tape->strings_length > 0) ? tape->strings_length : 1);
+        if (entries != NULL)
+        {
+            tape->entries = entries;
+        }
+        if (strings != NULL)
+        {
+            tape->strings = strings;
+        }
     }
+    global_hooks.deallocate(builder);
 
-    return buffer;
+    return tape;
+
+fail:
+    if (builder != NULL)
+    {
+        global_hooks.deallocate(builder);
+    }
+    cJSON_DeleteTape(tape);
+
+    return NULL;
 }
 
-/* skip the UTF-8 BOM (byte order mark) if it is at the beginning of a buffer */
-static parse_buffer *skip_utf8_bom(parse_buffer * const buffer)
+CJSON_PUBLIC(void) cJSON_DeleteTape(cJSON_Tape *tape)
 {
-    if ((buffer == NULL) || (buffer->content == NULL) || (buffer->offset != 0))
+    if (tape == NULL)
     {
-        return NULL;
+        return;
     }
 
-    if (can_access_at_index(buffer, 4) && (strncmp((const char*)buffer_at_offset(buffer), "\xEF\xBB\xBF", 3) == 0))
+    if (tape->entries != NULL)
     {
-        buffer->offset += 3;
+        global_hooks.deallocate(tape->entries);
+    }
+    if (tape->strings != NULL)
+    {
+        global_hooks.deallocate(tape->strings);
     }
+    global_hooks.deallocate(tape);
+}
 
-    return buffer;
+static cJSON_TapeItem tape_no_item(void)
+{
+    cJSON_TapeItem item;
+
+    item.tape = NULL;
+    item.index = 0;
+    item.name = 0;
+
+    return item;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated)
+/* the item starting at an entry: the value itself, the member behind a name, or none at the end of a container */
+static cJSON_TapeItem tape_item(const cJSON_Tape * const tape, const size_t index)
 {
-    size_t buffer_length;
+    cJSON_TapeItem item;
 
-    if (NULL == value)
+    if ((index >= tape->count) || (tape->entries[index].tag.type == TAPE_END))
     {
-        return NULL;
+        return tape_no_item();
     }
 
-    /* Adding null character size due to require_null_terminated. */
-    buffer_length = strlen(value) + sizeof("");
+    /* tape_reserve keeps every index within 32 bits */
+    item.tape = tape;
+    item.index = (unsigned int)index;
+    item.name = 0;
+    if (tape->entries[index].tag.type == TAPE_NAME)
+    {
+        item.name = (unsigned int)index;
+        item.index = (unsigned int)(index + 1);
+    }
 
-    return cJSON_ParseWithLengthOpts(value, buffer_length, return_parse_end, require_null_terminated);
+    return item;
 }
 
-/* Parse an object - create a new root, and populate. */
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated)
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeRoot(const cJSON_Tape *tape)
 {
-    parse_buffer buffer = { 0, 0, 0, 0, { 0, 0, 0 } };
-    cJSON *item = NULL;
+    if (tape == NULL)
+    {
+        return tape_no_item();
+    }
 
-    /* reset error position */
-    global_error.json = NULL;
-    global_error.position = 0;
+    return tape_item(tape, 0);
+}
 
-    if (value == NULL || 0 == buffer_length)
+CJSON_PUBLIC(int) cJSON_TapeType(const cJSON_TapeItem item)
+{
+    if (item.tape == NULL)
     {
-        goto fail;
+        return cJSON_Invalid;
     }
 
-    buffer.content = (const unsigned char*)value;
-    buffer.length = buffer_length;
-    buffer.offset = 0;
-    buffer.hooks = global_hooks;
+    return (int)item.tape->entries[item.index].tag.type;
+}
 
-    item = cJSON_New_Item(&global_hooks);
-    if (item == NULL) /* memory fail */
+CJSON_PUBLIC(double) cJSON_TapeNumber(const cJSON_TapeItem item)
+{
+    if (cJSON_TapeType(item) != cJSON_Number)
     {
-        goto fail;
+        return (double) NAN;
     }
 
-    if (!parse_value(item, buffer_skip_whitespace(skip_utf8_bom(&buffer))))
+    return item.tape->entries[item.index + 1].number;
+}
+
+CJSON_PUBLIC(const char *) cJSON_TapeString(const cJSON_TapeItem item)
+{
+    if (cJSON_TapeType(item) != cJSON_String)
     {
-        /* parse failure. ep is set. */
-        goto fail;
+        return NULL;
     }
 
-    /* if we require null-terminated JSON without appended garbage, skip and then check for a null terminator */
-    if (require_null_terminated)
+    return item.tape->strings + item.tape->entries[item.index].tag.payload;
+}
+
+CJSON_PUBLIC(const char *) cJSON_TapeName(const cJSON_TapeItem item)
+{
+    if ((item.tape == NULL) || (item.name == 0))
     {
-        buffer_skip_whitespace(&buffer);
-        if ((buffer.offset >= buffer.length) || buffer_at_offset(&buffer)[0] != '\0')
-        {
-            goto fail;
-        }
+        return NULL;
     }
-    if (return_parse_end)
+
+    return item.tape->strings + item.tape->entries[item.name].tag.payload;
+}
+
+CJSON_PUBLIC(int) cJSON_TapeSize(const cJSON_TapeItem item)
+{
+    const int type = cJSON_TapeType(item);
+    unsigned int count = 0;
+
+    if ((type != cJSON_Object) && (type != cJSON_Array))
     {
-        *return_parse_end = (const char*)buffer_at_offset(&buffer);
+        return 0;
     }
+    count = item.tape->entries[item.tape->entries[item.index].tag.payload - 1].tag.payload;
 
-    return item;
+    return (count > INT_MAX) ? INT_MAX : (int)count;
+}
 
-fail:
-    if (item != NULL)
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeChild(const cJSON_TapeItem item)
+{
+    const int type = cJSON_TapeType(item);
+
+    if ((type != cJSON_Object) && (type != cJSON_Array))
     {
-        cJSON_Delete(item);
+        return tape_no_item();
     }
 
-    if (value != NULL)
-    {
-        error local_error;
-        local_error.json = (const unsigned char*)value;
-        local_error.position = 0;
+    return tape_item(item.tape, item.index + 1);
+}
 
-        if (buffer.offset < buffer.length)
-        {
-            local_error.position = buffer.offset;
-        }
-        else if (buffer.length > 0)
-        {
-            local_error.position = buffer.length - 1;
-        }
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeNext(const cJSON_TapeItem item)
+{
+    size_t next = 0;
 
-        if (return_parse_end != NULL)
-        {
-            *return_parse_end = (const char*)local_error.json + local_error.position;
-        }
+    if ((item.tape == NULL) || (item.index == 0))
+    {
+        return tape_no_item(); /* the root has no siblings */
+    }
 
-        global_error = local_error;
+    switch (item.tape->entries[item.index].tag.type)
+    {
+        case cJSON_Object:
+        case cJSON_Array:
+            next = item.tape->entries[item.index].tag.payload;
+            break;
+        case cJSON_Number:
+            next = item.index + 2;
+            break;
+        default:
+            next = item.index + 1;
+            break;
     }
 
-    return NULL;
+    return tape_item(item.tape, next);
 }
 
-/* Default options for cJSON_Parse */
-CJSON_PUBLIC(cJSON *) cJSON_Parse(const char *value)
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeGetArrayItem(const cJSON_TapeItem array, int index)
 {
-    return cJSON_ParseWithOpts(value, 0, 0);
+    cJSON_TapeItem element;
+
+    if ((cJSON_TapeType(array) != cJSON_Array) || (index < 0))
+    {
+        return tape_no_item();
+    }
+
+    for (element = cJSON_TapeChild(array); (element.tape != NULL) && (index > 0); index--)
+    {
+        element = cJSON_TapeNext(element);
+    }
+
+    return element;
 }
 
-CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_length)
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeGetObjectItem(const cJSON_TapeItem object, const char * const string)
 {
-    return cJSON_ParseWithLengthOpts(value, buffer_length, 0, 0);
+    cJSON_TapeItem member;
+
+    if ((cJSON_TapeType(object) != cJSON_Object) || (string == NULL))
+    {
+        return tape_no_item();
+    }
+
+    cJSON_TapeForEach(member, object)
+    {
+        if (strcmp(string, cJSON_TapeName(member)) == 0)
+        {
+            break;
+        }
+    }
+
+    return member;
 }
 
 #define cjson_min(a, b) (((a) < (b)) ? (a) : (b))
@@ -1261,7 +4422,7 @@ CJSON_PUBLIC(char *) cJSON_PrintUnformatted(const cJSON *item)
 
 CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON_bool fmt)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, 0, 0 }, NULL, NULL };
 
     if (prebuffer < 0)
     {
@@ -1291,7 +4452,7 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format)
 {
-    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0 } };
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, 0, 0 }, NULL, NULL };
 
     if ((length < 0) || (buffer == NULL))
     {
@@ -1308,15 +4469,70 @@ CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, cons
     return print_value(item, &p);
 }
 
-/* Parser core - when encountering text, process appropriately. */
-static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToSink(const cJSON *item, cJSON_bool format, cJSON_PrintSink sink, void *context)
 {
-    if ((input_buffer == NULL) || (input_buffer->content == NULL))
+    printbuffer p = { 0, 0, 0, 0, 0, 0, { 0, 0, 0, 0, 0 }, NULL, NULL };
+    cJSON_bool printed = false;
+
+    if ((item == NULL) || (sink == NULL))
     {
-        return false; /* no input */
+        return false;
+    }
+
+    p.buffer = (unsigned char*)global_hooks.allocate(CJSON_PRINT_CHUNK_SIZE);
+    if (p.buffer == NULL)
+    {
+        return false;
     }
 
-    /* parse the different types of values */
+    p.length = CJSON_PRINT_CHUNK_SIZE;
+    p.offset = 0;
+    p.noalloc = false;
+    p.format = format;
+    p.hooks = global_hooks;
+    p.sink = sink;
+    p.sink_context = context;
+
+    printed = print_value(item, &p) && flush_printbuffer(&p);
+
+    /* ensure frees the buffer when it fails to grow it */
+    if (p.buffer != NULL)
+    {
+        global_hooks.deallocate(p.buffer);
+    }
+
+    return printed;
+}
+
+/* Double an explicit stack that starts out in a fixed array on the C stack (inline_stack).
+ * Heap copies come from the plain allocator, never the arena or pool, and the caller frees the last one. */
+static void *grow_stack(void *stack, const void *inline_stack, size_t * const capacity, size_t size, const internal_hooks * const hooks)
+{
+    void *grown = NULL;
+
+    if (*capacity > (((size_t)-1) / 2 / size))
+    {
+        return NULL;
+    }
+
+    grown = hooks->allocate(*capacity * 2 * size);
+    if (grown == NULL)
+    {
+        return NULL;
+    }
+    memcpy(grown, stack, *capacity * size);
+    if (stack != inline_stack)
+    {
+        hooks->deallocate(stack);
+    }
+    *capacity *= 2;
+
+    return grown;
+}
+
+/* Parse a value that is not an array or object. */
+static cJSON_bool parse_scalar(cJSON * const item, parse_buffer * const input_buffer)
+{
     /* null */
     if (can_read(input_buffer, 4) && (strncmp((const char*)buffer_at_offset(input_buffer), "null", 4) == 0))
     {
@@ -1349,479 +4565,486 @@ static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buf
     {
         return parse_number(item, input_buffer);
     }
-    /* array */
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '['))
-    {
-        return parse_array(item, input_buffer);
-    }
-    /* object */
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '{'))
-    {
-        return parse_object(item, input_buffer);
-    }
 
     return false;
 }
 
-/* Render a value to text. */
-static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer)
+/* An array or object that parse_value has opened but not closed yet. */
+typedef struct
 {
-    unsigned char *output = NULL;
+    cJSON *item;
+} parse_frame;
 
-    if ((item == NULL) || (output_buffer == NULL))
+#define PARSE_STACK_INLINE 32
+
+/* Parser core - when encountering text, process appropriately.
+ * Arrays and objects are handled without recursion: the containers that are still open live on an explicit stack,
+ * so the C stack use does not grow with the nesting depth. Children are linked into their container as soon as
+ * they are created, which lets a failure anywhere clean up by deleting the root item. */
+static cJSON_bool parse_value(cJSON * const item, parse_buffer * const input_buffer)
+{
+    parse_frame inline_frames[PARSE_STACK_INLINE];
+    parse_frame *frames = inline_frames;
+    size_t capacity = PARSE_STACK_INLINE;
+    size_t open = 0;
+    parse_frame *frame = NULL;
+    cJSON *current = item;
+    cJSON *new_item = NULL;
+    cJSON_bool parsed = false;
+
+    if ((input_buffer == NULL) || (input_buffer->content == NULL))
     {
-        return false;
+        return false; /* no input */
     }
 
-    switch ((item->type) & 0xFF)
+    for (;;)
     {
-        case cJSON_NULL:
-            output = ensure(output_buffer, 5);
-            if (output == NULL)
+        /* parse the value that goes into current */
+        if (can_access_at_index(input_buffer, 0) && ((buffer_at_offset(input_buffer)[0] == '[') || (buffer_at_offset(input_buffer)[0] == '{')))
+        {
+            if (input_buffer->depth >= CJSON_NESTING_LIMIT)
             {
-                return false;
+                goto done; /* to deeply nested */
             }
-            strcpy((char*)output, "null");
-            return true;
-
-        case cJSON_False:
-            output = ensure(output_buffer, 6);
-            if (output == NULL)
+            if (open == capacity)
             {
-                return false;
+                parse_frame *grown = (parse_frame*)grow_stack(frames, inline_frames, &capacity, sizeof(parse_frame), &input_buffer->hooks);
+                if (grown == NULL)
+                {
+                    goto done; /* allocation failure */
+                }
+                frames = grown;
             }
-            strcpy((char*)output, "false");
-            return true;
+            input_buffer->depth++;
 
-        case cJSON_True:
-            output = ensure(output_buffer, 5);
-            if (output == NULL)
+            frame = &frames[open++];
+            frame->item = current;
+            /* an in-situ member name stays flagged even if the container never closes */
+            current->type = (current->type & cJSON_StringIsConst) | ((buffer_at_offset(input_buffer)[0] == '[') ? cJSON_Array : cJSON_Object);
+
+            input_buffer->offset++;
+            buffer_skip_whitespace(input_buffer);
+            if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != (((current->type & 0xFF) == cJSON_Array) ? ']' : '}')))
             {
-                return false;
+                /* check if we skipped to the end of the buffer */
+                if (cannot_access_at_index(input_buffer, 0))
+                {
+                    input_buffer->offset--;
+                    goto done;
+                }
+
+                /* step back to character in front of the first element */
+                input_buffer->offset--;
+                goto element;
             }
-            strcpy((char*)output, "true");
-            return true;
 
-        case cJSON_Number:
-            return print_number(item, output_buffer);
+            /* empty array or object */
+            input_buffer->depth--;
+            input_buffer->offset++;
+            open--;
+        }
+        else if (!parse_scalar(current, input_buffer))
+        {
+            goto done;
+        }
 
-        case cJSON_Raw:
+        /* the value is complete, continue with its container */
+        while (open > 0)
         {
-            size_t raw_length = 0;
-            if (item->valuestring == NULL)
+            frame = &frames[open - 1];
+            if ((input_buffer->in_situ != NULL) && ((frame->item->type & 0xFF) == cJSON_Object))
             {
-                return false;
+                current->type |= cJSON_StringIsConst;
             }
-
-            raw_length = strlen(item->valuestring) + sizeof("");
-            output = ensure(output_buffer, raw_length);
-            if (output == NULL)
+            buffer_skip_whitespace(input_buffer);
+            if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','))
             {
-                return false;
+                goto element;
+            }
+            if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != (((frame->item->type & 0xFF) == cJSON_Array) ? ']' : '}')))
+            {
+                goto done; /* expected end of array or object */
             }
-            memcpy(output, item->valuestring, raw_length);
-            return true;
-        }
-
-        case cJSON_String:
-            return print_string(item, output_buffer);
-
-        case cJSON_Array:
-            return print_array(item, output_buffer);
-
-        case cJSON_Object:
-            return print_object(item, output_buffer);
-
-        default:
-            return false;
-    }
-}
-
-/* Build an array from input text. */
-static cJSON_bool parse_array(cJSON * const item, parse_buffer * const input_buffer)
-{
-    cJSON *head = NULL; /* head of the linked list */
-    cJSON *current_item = NULL;
-
-    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
-    {
-        return false; /* to deeply nested */
-    }
-    input_buffer->depth++;
 
-    if (buffer_at_offset(input_buffer)[0] != '[')
-    {
-        /* not an array */
-        goto fail;
-    }
+            input_buffer->depth--;
+            if (frame->item->child != NULL)
+            {
+                /* current is the last child */
+                frame->item->child->prev = current;
+            }
+            input_buffer->offset++;
 
-    input_buffer->offset++;
-    buffer_skip_whitespace(input_buffer);
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ']'))
-    {
-        /* empty array */
-        goto success;
-    }
+            current = frame->item;
+            open--;
+        }
 
-    /* check if we skipped to the end of the buffer */
-    if (cannot_access_at_index(input_buffer, 0))
-    {
-        input_buffer->offset--;
-        goto fail;
-    }
+        parsed = true;
+        goto done;
 
-    /* step back to character in front of the first element */
-    input_buffer->offset--;
-    /* loop through the comma separated array elements */
-    do
-    {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
+element:
+        /* allocate the next element of the innermost container and link it in */
+        new_item = cJSON_New_Item(&(input_buffer->hooks));
         if (new_item == NULL)
         {
-            goto fail; /* allocation failure */
+            goto done; /* allocation failure */
         }
-
-        /* attach next item to list */
-        if (head == NULL)
+        if (frame->item->child == NULL)
         {
-            /* start the linked list */
-            current_item = head = new_item;
+            frame->item->child = new_item;
         }
         else
         {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
+            current->next = new_item;
+            new_item->prev = current;
         }
+        current = new_item;
 
-        /* parse next value */
         input_buffer->offset++;
         buffer_skip_whitespace(input_buffer);
-        if (!parse_value(current_item, input_buffer))
+        if ((frame->item->type & 0xFF) == cJSON_Object)
         {
-            goto fail; /* failed to parse value */
-        }
-        buffer_skip_whitespace(input_buffer);
-    }
-    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
-
-    if (cannot_access_at_index(input_buffer, 0) || buffer_at_offset(input_buffer)[0] != ']')
-    {
-        goto fail; /* expected end of array */
-    }
+            /* parse the name of the child */
+            if (!parse_string(current, input_buffer))
+            {
+                goto done; /* failed to parse name */
+            }
+            buffer_skip_whitespace(input_buffer);
 
-success:
-    input_buffer->depth--;
+            /* swap valuestring and string, because we parsed the name */
+            current->string = current->valuestring;
+            current->valuestring = NULL;
+            if (input_buffer->in_situ != NULL)
+            {
+                /* the name lives in the caller's buffer, keep cJSON_Delete from freeing it */
+                current->type = cJSON_StringIsConst;
+            }
 
-    if (head != NULL) {
-        head->prev = current_item;
+            if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+            {
+                goto done; /* invalid object */
+            }
+            input_buffer->offset++;
+            buffer_skip_whitespace(input_buffer);
+        }
     }
 
-    item->type = cJSON_Array;
-    item->child = head;
-
-    input_buffer->offset++;
-
-    return true;
-
-fail:
-    if (head != NULL)
+done:
+    if (frames != inline_frames)
     {
-        cJSON_Delete(head);
+        input_buffer->hooks.deallocate(frames);
     }
 
-    return false;
+    return parsed;
 }
 
-/* Render an array to text */
-static cJSON_bool print_array(const cJSON * const item, printbuffer * const output_buffer)
+/* Render a value that is not an array or object to text. */
+static cJSON_bool print_scalar(const cJSON * const item, printbuffer * const output_buffer)
 {
-    unsigned char *output_pointer = NULL;
-    size_t length = 0;
-    cJSON *current_element = item->child;
+    unsigned char *output = NULL;
 
-    if (output_buffer == NULL)
+    switch ((item->type) & 0xFF)
     {
-        return false;
-    }
+        case cJSON_NULL:
+            output = ensure(output_buffer, 5);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "null");
+            return true;
 
-    /* Compose the output array. */
-    /* opening square bracket */
-    output_pointer = ensure(output_buffer, 1);
-    if (output_pointer == NULL)
-    {
-        return false;
-    }
+        case cJSON_False:
+            output = ensure(output_buffer, 6);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "false");
+            return true;
 
-    *output_pointer = '[';
-    output_buffer->offset++;
-    output_buffer->depth++;
+        case cJSON_True:
+            output = ensure(output_buffer, 5);
+            if (output == NULL)
+            {
+                return false;
+            }
+            strcpy((char*)output, "true");
+            return true;
 
-    while (current_element != NULL)
-    {
-        if (!print_value(current_element, output_buffer))
-        {
-            return false;
-        }
-        update_offset(output_buffer);
-        if (current_element->next)
+        case cJSON_Number:
+            return print_number(item, output_buffer);
+
+        case cJSON_Raw:
         {
-            length = (size_t) (output_buffer->format ? 2 : 1);
-            output_pointer = ensure(output_buffer, length + 1);
-            if (output_pointer == NULL)
+            size_t raw_length = 0;
+            if (item->valuestring == NULL)
             {
                 return false;
             }
-            *output_pointer++ = ',';
-            if(output_buffer->format)
+
+            raw_length = strlen(item->valuestring) + sizeof("");
+            output = ensure(output_buffer, raw_length);
+            if (output == NULL)
             {
-                *output_pointer++ = ' ';
+                return false;
             }
-            *output_pointer = '\0';
-            output_buffer->offset += length;
+            memcpy(output, item->valuestring, raw_length);
+            return true;
         }
-        current_element = current_element->next;
-    }
-
-    output_pointer = ensure(output_buffer, 2);
-    if (output_pointer == NULL)
-    {
-        return false;
-    }
-    *output_pointer++ = ']';
-    *output_pointer = '\0';
-    output_buffer->depth--;
 
-    return true;
+        case cJSON_String:
+            return print_string(item, output_buffer);
+
+        default:
+            return false;
+    }
 }
 
-/* Build an object from the text. */
-static cJSON_bool parse_object(cJSON * const item, parse_buffer * const input_buffer)
+/* Open an array or object: "[" or "{" followed by a newline when formatting. */
+static cJSON_bool print_container_start(const cJSON * const item, printbuffer * const output_buffer)
 {
-    cJSON *head = NULL; /* linked list head */
-    cJSON *current_item = NULL;
-
-    if (input_buffer->depth >= CJSON_NESTING_LIMIT)
-    {
-        return false; /* to deeply nested */
-    }
-    input_buffer->depth++;
+    unsigned char *output_pointer = NULL;
+    size_t length = 1;
 
-    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '{'))
+    if (((item->type & 0xFF) == cJSON_Object) && output_buffer->format)
     {
-        goto fail; /* not an object */
+        length = 2; /* fmt: {\n */
     }
-
-    input_buffer->offset++;
-    buffer_skip_whitespace(input_buffer);
-    if (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == '}'))
+    output_pointer = ensure(output_buffer, ((item->type & 0xFF) == cJSON_Array) ? 1 : (length + 1));
+    if (output_pointer == NULL)
     {
-        goto success; /* empty object */
+        return false;
     }
 
-    /* check if we skipped to the end of the buffer */
-    if (cannot_access_at_index(input_buffer, 0))
+    *output_pointer++ = ((item->type & 0xFF) == cJSON_Array) ? '[' : '{';
+    if (length == 2)
     {
-        input_buffer->offset--;
-        goto fail;
+        *output_pointer = '\n';
     }
+    output_buffer->offset += length;
+    output_buffer->depth++;
 
-    /* step back to character in front of the first element */
-    input_buffer->offset--;
-    /* loop through the comma separated array elements */
-    do
-    {
-        /* allocate next item */
-        cJSON *new_item = cJSON_New_Item(&(input_buffer->hooks));
-        if (new_item == NULL)
-        {
-            goto fail; /* allocation failure */
-        }
-
-        /* attach next item to list */
-        if (head == NULL)
-        {
-            /* start the linked list */
-            current_item = head = new_item;
-        }
-        else
-        {
-            /* add to the end and advance */
-            current_item->next = new_item;
-            new_item->prev = current_item;
-            current_item = new_item;
-        }
-
-        /* parse the name of the child */
-        input_buffer->offset++;
-        buffer_skip_whitespace(input_buffer);
-        if (!parse_string(current_item, input_buffer))
-        {
-            goto fail; /* failed to parse name */
-        }
-        buffer_skip_whitespace(input_buffer);
+    return true;
+}
 
-        /* swap valuestring and string, because we parsed the name */
-        current_item->string = current_item->valuestring;
-        current_item->valuestring = NULL;
+/* Print what comes in front of an object member: its indentation and name. */
+static cJSON_bool print_member_name(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+    size_t length = 0;
 
-        if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != ':'))
+    if (output_buffer->format)
+    {
+        size_t i;
+        output_pointer = ensure(output_buffer, output_buffer->depth);
+        if (output_pointer == NULL)
         {
-            goto fail; /* invalid object */
+            return false;
         }
-
-        /* parse the value */
-        input_buffer->offset++;
-        buffer_skip_whitespace(input_buffer);
-        if (!parse_value(current_item, input_buffer))
+        for (i = 0; i < output_buffer->depth; i++)
         {
-            goto fail; /* failed to parse value */
+            *output_pointer++ = '\t';
         }
-        buffer_skip_whitespace(input_buffer);
+        output_buffer->offset += output_buffer->depth;
     }
-    while (can_access_at_index(input_buffer, 0) && (buffer_at_offset(input_buffer)[0] == ','));
 
-    if (cannot_access_at_index(input_buffer, 0) || (buffer_at_offset(input_buffer)[0] != '}'))
+    /* print key */
+    if (!print_string_ptr((unsigned char*)item->string, output_buffer))
     {
-        goto fail; /* expected end of object */
+        return false;
     }
+    update_offset(output_buffer);
 
-success:
-    input_buffer->depth--;
-
-    if (head != NULL) {
-        head->prev = current_item;
+    length = (size_t) (output_buffer->format ? 2 : 1);
+    output_pointer = ensure(output_buffer, length);
+    if (output_pointer == NULL)
+    {
+        return false;
     }
-
-    item->type = cJSON_Object;
-    item->child = head;
-
-    input_buffer->offset++;
-    return true;
-
-fail:
-    if (head != NULL)
+    *output_pointer++ = ':';
+    if (output_buffer->format)
     {
-        cJSON_Delete(head);
+        *output_pointer++ = '\t';
     }
+    output_buffer->offset += length;
 
-    return false;
+    return true;
 }
 
-/* Render an object to text. */
-static cJSON_bool print_object(const cJSON * const item, printbuffer * const output_buffer)
+/* Print what comes after an element: the comma if it is not the last one, and the newline of an object member. */
+static cJSON_bool print_element_end(const cJSON * const container, const cJSON * const item, printbuffer * const output_buffer)
 {
     unsigned char *output_pointer = NULL;
     size_t length = 0;
-    cJSON *current_item = item->child;
+    cJSON_bool is_object = ((container->type & 0xFF) == cJSON_Object);
 
-    if (output_buffer == NULL)
+    if (is_object)
     {
-        return false;
+        length = ((size_t)(output_buffer->format ? 1 : 0) + (size_t)(item->next ? 1 : 0));
+    }
+    else if (item->next)
+    {
+        length = (size_t) (output_buffer->format ? 2 : 1);
+    }
+    else
+    {
+        return true;
     }
 
-    /* Compose the output: */
-    length = (size_t) (output_buffer->format ? 2 : 1); /* fmt: {\n */
     output_pointer = ensure(output_buffer, length + 1);
     if (output_pointer == NULL)
     {
         return false;
     }
-
-    *output_pointer++ = '{';
-    output_buffer->depth++;
+    if (item->next)
+    {
+        *output_pointer++ = ',';
+    }
     if (output_buffer->format)
     {
-        *output_pointer++ = '\n';
+        *output_pointer++ = is_object ? '\n' : ' ';
     }
+    *output_pointer = '\0';
     output_buffer->offset += length;
 
-    while (current_item)
-    {
-        if (output_buffer->format)
-        {
-            size_t i;
-            output_pointer = ensure(output_buffer, output_buffer->depth);
-            if (output_pointer == NULL)
-            {
-                return false;
-            }
-            for (i = 0; i < output_buffer->depth; i++)
-            {
-                *output_pointer++ = '\t';
-            }
-            output_buffer->offset += output_buffer->depth;
-        }
+    return true;
+}
 
-        /* print key */
-        if (!print_string_ptr((unsigned char*)current_item->string, output_buffer))
+/* Close an array or object, with the indentation of its parent in front of a formatted "}". */
+static cJSON_bool print_container_end(const cJSON * const item, printbuffer * const output_buffer)
+{
+    unsigned char *output_pointer = NULL;
+
+    if ((item->type & 0xFF) == cJSON_Array)
+    {
+        output_pointer = ensure(output_buffer, 2);
+        if (output_pointer == NULL)
         {
             return false;
         }
-        update_offset(output_buffer);
-
-        length = (size_t) (output_buffer->format ? 2 : 1);
-        output_pointer = ensure(output_buffer, length);
+        *output_pointer++ = ']';
+    }
+    else
+    {
+        output_pointer = ensure(output_buffer, output_buffer->format ? (output_buffer->depth + 1) : 2);
         if (output_pointer == NULL)
         {
             return false;
         }
-        *output_pointer++ = ':';
         if (output_buffer->format)
         {
-            *output_pointer++ = '\t';
+            size_t i;
+            for (i = 0; i < (output_buffer->depth - 1); i++)
+            {
+                *output_pointer++ = '\t';
+            }
         }
-        output_buffer->offset += length;
+        *output_pointer++ = '}';
+    }
+    *output_pointer = '\0';
+    output_buffer->depth--;
+    update_offset(output_buffer);
+
+    return true;
+}
+
+#define PRINT_STACK_INLINE 64
+
+/* Render a value to text.
+ * Like parse_value this does not recurse: the arrays and objects being printed are kept on an explicit stack,
+ * with the innermost one in container and its element being printed in current. */
+static cJSON_bool print_value(const cJSON * const item, printbuffer * const output_buffer)
+{
+    const cJSON *inline_containers[PRINT_STACK_INLINE];
+    const cJSON **containers = inline_containers;
+    size_t capacity = PRINT_STACK_INLINE;
+    size_t open = 0;
+    const cJSON *container = NULL;
+    const cJSON *current = item;
+    cJSON_bool printed = false;
+
+    if ((item == NULL) || (output_buffer == NULL))
+    {
+        return false;
+    }
 
-        /* print value */
-        if (!print_value(current_item, output_buffer))
+    for (;;)
+    {
+        if ((container != NULL) && ((container->type & 0xFF) == cJSON_Object) && !print_member_name(current, output_buffer))
         {
-            return false;
+            goto done;
         }
-        update_offset(output_buffer);
 
-        /* print comma if not last */
-        length = ((size_t)(output_buffer->format ? 1 : 0) + (size_t)(current_item->next ? 1 : 0));
-        output_pointer = ensure(output_buffer, length + 1);
-        if (output_pointer == NULL)
+        if (((current->type & 0xFF) == cJSON_Array) || ((current->type & 0xFF) == cJSON_Object))
         {
-            return false;
+            if (!print_container_start(current, output_buffer))
+            {
+                goto done;
+            }
+            if (current->child != NULL)
+            {
+                if (open == capacity)
+                {
+                    const cJSON **grown = (const cJSON**)grow_stack(containers, inline_containers, &capacity, sizeof(const cJSON*), &output_buffer->hooks);
+                    if (grown == NULL)
+                    {
+                        goto done; /* allocation failure */
+                    }
+                    containers = grown;
+                }
+                containers[open++] = current;
+                container = current;
+                current = current->child;
+                continue;
+            }
+            if (!print_container_end(current, output_buffer))
+            {
+                goto done;
+            }
         }
-        if (current_item->next)
+        else
         {
-            *output_pointer++ = ',';
+            if (!print_scalar(current, output_buffer))
+            {
+                goto done;
+            }
+            update_offset(output_buffer);
         }
 
-        if (output_buffer->format)
+        /* current is printed, move on to its next sibling or close its container */
+        while (container != NULL)
         {
-            *output_pointer++ = '\n';
+            if (!print_element_end(container, current, output_buffer))
+            {
+                goto done;
+            }
+            if (current->next != NULL)
+            {
+                break;
+            }
+            current = container;
+            open--;
+            container = (open > 0) ? containers[open - 1] : NULL;
+            if (!print_container_end(current, output_buffer))
+            {
+                goto done;
+            }
         }
-        *output_pointer = '\0';
-        output_buffer->offset += length;
-
-        current_item = current_item->next;
+        if (container == NULL)
+        {
+            printed = true;
+            goto done;
+        }
+        current = current->next;
     }
 
-    output_pointer = ensure(output_buffer, output_buffer->format ? (output_buffer->depth + 1) : 2);
-    if (output_pointer == NULL)
-    {
-        return false;
-    }
-    if (output_buffer->format)
+done:
+    if (containers != inline_containers)
     {
-        size_t i;
-        for (i = 0; i < (output_buffer->depth - 1); i++)
-        {
-            *output_pointer++ = '\t';
-        }
+        output_buffer->hooks.deallocate(containers);
     }
-    *output_pointer++ = '}';
-    *output_pointer = '\0';
-    output_buffer->depth--;
 
-    return true;
+    return printed;
 }
 
 /* Get Array size/item / object item. */
@@ -1834,6 +5057,10 @@ CJSON_PUBLIC(int) cJSON_GetArraySize(const cJSON *array)
     {
         return 0;
     }
+    if (index_in_step(array))
+    {
+        return (int)array->index->count;
+    }
 
     child = array->child;
 
@@ -1856,6 +5083,10 @@ static cJSON* get_array_item(const cJSON *array, size_t index)
     {
         return NULL;
     }
+    if (is_array(array) && index_in_step(array))
+    {
+        return (index < array->index->count) ? array->index->table.items[index] : NULL;
+    }
 
     current_child = array->child;
     while ((current_child != NULL) && (index > 0))
@@ -1886,6 +5117,11 @@ static cJSON *get_object_item(const cJSON * const object, const char * const nam
         return NULL;
     }
 
+    if (!is_array(object) && index_in_step(object))
+    {
+        return find_indexed_item(object->index, name, case_sensitive);
+    }
+
     current_element = object->child;
     if (case_sensitive)
     {
@@ -1948,6 +5184,7 @@ static cJSON *create_reference(const cJSON *item, const internal_hooks * const h
 
     memcpy(reference, item, sizeof(cJSON));
     reference->string = NULL;
+    reference->index = NULL; /* the index stays with the referenced object */
     reference->type |= cJSON_IsReference;
     reference->next = reference->prev = NULL;
     return reference;
@@ -1972,6 +5209,7 @@ static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
         array->child = item;
         item->prev = item;
         item->next = NULL;
+        append_to_index(array, item);
     }
     else
     {
@@ -1980,6 +5218,7 @@ static cJSON_bool add_item_to_array(cJSON *array, cJSON *item)
         {
             suffix_object(child->prev, item);
             array->child->prev = item;
+            append_to_index(array, item);
         }
     }
 
@@ -2191,6 +5430,7 @@ CJSON_PUBLIC(cJSON *) cJSON_DetachItemViaPointer(cJSON *parent, cJSON * const it
         return NULL;
     }
 
+    cJSON_DropIndex(parent);
     if (item != parent->child)
     {
         /* not the first element */
@@ -2275,6 +5515,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_InsertItemInArray(cJSON *array, int which, cJSON
         return add_item_to_array(array, newitem);
     }
 
+    cJSON_DropIndex(array);
     newitem->next = after_inserted;
     newitem->prev = after_inserted->prev;
     after_inserted->prev = newitem;
@@ -2301,6 +5542,7 @@ CJSON_PUBLIC(cJSON_bool) cJSON_ReplaceItemViaPointer(cJSON * const parent, cJSON
         return true;
     }
 
+    cJSON_DropIndex(parent);
     replacement->next = item->next;
     replacement->prev = item->prev;
 
@@ -3108,6 +6350,124 @@ CJSON_PUBLIC(cJSON_bool) cJSON_Compare(const cJSON * const a, const cJSON * cons
     }
 }
 
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t block_size)
+{
+    cJSON_Arena *arena = (cJSON_Arena*)global_hooks.allocate(sizeof(cJSON_Arena));
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    arena->blocks = NULL;
+    arena->block_size = (block_size > 0) ? block_size : CJSON_ARENA_BLOCK_SIZE;
+
+    return arena;
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(cJSON_Arena *arena, const char *value, size_t buffer_length)
+{
+    internal_hooks hooks;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    hooks = global_hooks;
+    hooks.arena = arena;
+
+    return parse_with_hooks(value, buffer_length, NULL, false, &hooks, NULL, &global_error);
+}
+
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSituWithArena(cJSON_Arena *arena, char *value, size_t buffer_length)
+{
+    internal_hooks hooks;
+
+    if (arena == NULL)
+    {
+        return NULL;
+    }
+    hooks = global_hooks;
+    hooks.arena = arena;
+
+    return parse_with_hooks(value, buffer_length, NULL, false, &hooks, value, &global_error);
+}
+
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena)
+{
+    cJSON_ArenaBlock *block = NULL;
+    size_t total_size = 0;
+
+    if ((arena == NULL) || (arena->blocks == NULL))
+    {
+        return;
+    }
+
+    /* a single block is kept for reuse */
+    if (arena->blocks->next == NULL)
+    {
+        arena->blocks->used = 0;
+        return;
+    }
+
+    /* several blocks are merged into one as large as all of them, so the next parse of a similar document needs no allocation */
+    block = arena->blocks;
+    while (block != NULL)
+    {
+        cJSON_ArenaBlock *next = block->next;
+        total_size += block->size;
+        global_hooks.deallocate(block);
+        block = next;
+    }
+    arena->blocks = arena_new_block(total_size);
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena)
+{
+    if (arena == NULL)
+    {
+        return;
+    }
+
+    cJSON_ResetArena(arena);
+    if (arena->blocks != NULL)
+    {
+        global_hooks.deallocate(arena->blocks);
+    }
+    global_hooks.deallocate(arena);
+}
+
+CJSON_PUBLIC(cJSON_NodePool *) cJSON_CreateNodePool(size_t slab_nodes)
+{
+    cJSON_NodePool *pool = (cJSON_NodePool*)global_hooks.allocate(sizeof(cJSON_NodePool));
+    if (pool == NULL)
+    {
+        return NULL;
+    }
+    pool->slabs = NULL;
+    pool->free_nodes = NULL;
+    pool->slab_nodes = (slab_nodes > 0) ? slab_nodes : CJSON_POOL_SLAB_NODES;
+
+    return pool;
+}
+
+CJSON_PUBLIC(void) cJSON_DeleteNodePool(cJSON_NodePool *pool)
+{
+    cJSON_PoolSlab *slab = NULL;
+
+    if (pool == NULL)
+    {
+        return;
+    }
+
+    slab = pool->slabs;
+    while (slab != NULL)
+    {
+        cJSON_PoolSlab *next = slab->next;
+        global_hooks.deallocate(slab);
+        slab = next;
+    }
+    global_hooks.deallocate(pool);
+}
+
 CJSON_PUBLIC(void *) cJSON_malloc(size_t size)
 {
     return global_hooks.allocate(size);
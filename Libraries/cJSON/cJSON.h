@@ -120,6 +120,11 @@ typedef struct cJSON
 
     /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
     char *string;
+
+    /* Index over the children, only built on request: a hash of the keys after cJSON_IndexObject, or the items of an array after cJSON_IndexArray.
+     * NULL otherwise. Appending keeps it, any other cJSON call that changes the children drops it, and lookups ignore it once the first
+     * or last child is not the one it knows of; if you relink the children in between or rename a key by hand, release it via cJSON_DropIndex first. */
+    struct cJSON_Index *index;
 } cJSON;
 
 typedef struct cJSON_Hooks
@@ -137,6 +142,26 @@ typedef int cJSON_bool;
 #define CJSON_NESTING_LIMIT 1000
 #endif
 
+/* Size of the blocks an arena allocates when cJSON_CreateArena is given 0. */
+#ifndef CJSON_ARENA_BLOCK_SIZE
+#define CJSON_ARENA_BLOCK_SIZE 16384
+#endif
+
+/* Number of nodes in the slabs a node pool allocates when cJSON_CreateNodePool is given 0. */
+#ifndef CJSON_POOL_SLAB_NODES
+#define CJSON_POOL_SLAB_NODES 256
+#endif
+
+/* Size of the buffer cJSON_PrintToSink fills before it calls the sink. */
+#ifndef CJSON_PRINT_CHUNK_SIZE
+#define CJSON_PRINT_CHUNK_SIZE 4096
+#endif
+
+/* Limits how many paths cJSON_ExtractPaths resolves in one call. */
+#ifndef CJSON_PATH_LIMIT
+#define CJSON_PATH_LIMIT 32
+#endif
+
 /* returns the version of cJSON as a string */
 CJSON_PUBLIC(const char*) cJSON_Version(void);
 
@@ -152,6 +177,101 @@ CJSON_PUBLIC(cJSON *) cJSON_ParseWithLength(const char *value, size_t buffer_len
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithOpts(const char *value, const char **return_parse_end, cJSON_bool require_null_terminated);
 CJSON_PUBLIC(cJSON *) cJSON_ParseWithLengthOpts(const char *value, size_t buffer_length, const char **return_parse_end, cJSON_bool require_null_terminated);
 
+/* Arena allocation: cJSON_ParseWithArena takes every node and string of the tree from a few large blocks owned by the arena. */
+/* Such a tree is read-only: never pass it to cJSON_Delete or to functions that add, replace or detach items. */
+/* cJSON_ResetArena releases every tree parsed into the arena at once and keeps one block for the next parse. */
+typedef struct cJSON_Arena cJSON_Arena;
+CJSON_PUBLIC(cJSON_Arena *) cJSON_CreateArena(size_t block_size);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithArena(cJSON_Arena *arena, const char *value, size_t buffer_length);
+CJSON_PUBLIC(void) cJSON_ResetArena(cJSON_Arena *arena);
+CJSON_PUBLIC(void) cJSON_DeleteArena(cJSON_Arena *arena);
+
+/* In-situ parsing: strings and keys are unescaped in place in the caller's writable buffer and the tree points into it instead of copying them. */
+/* The buffer must outlive the tree and stay untouched; its contents are unspecified afterwards, also when the parse fails. */
+/* Delete the tree as usual. Its strings are references, so cJSON_SetValuestring refuses them, and cJSON_Duplicate still shares the keys with the buffer. */
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSitu(char *value, size_t buffer_length);
+CJSON_PUBLIC(cJSON *) cJSON_ParseInSituWithArena(cJSON_Arena *arena, char *value, size_t buffer_length);
+
+/* Reentrant parsing: cJSON_ParseWithContext takes its hooks from the context and reports its error there instead of in cJSON's globals, */
+/* so threads can parse at the same time, each with a context of its own, while cJSON_InitHooks and cJSON_GetErrorPtr are left alone. */
+/* NULL hooks mean malloc and free. Free the tree with cJSON_DeleteWithContext and the same hooks. After a failed parse error points where it stopped, otherwise it is NULL. */
+/* A node pool in the context hands out the tree's nodes from fixed-size slabs and takes them back on cJSON_DeleteWithContext, so short-lived trees stop hitting malloc for every node. */
+/* A pool is not locked: keep it to the thread that owns the context. cJSON_DeleteNodePool releases the slabs, so delete the trees first. */
+typedef struct cJSON_NodePool cJSON_NodePool;
+typedef struct cJSON_ParseContext
+{
+    cJSON_Hooks hooks;
+    const char *error;
+    cJSON_NodePool *pool; /* NULL to allocate nodes through the hooks */
+} cJSON_ParseContext;
+CJSON_PUBLIC(cJSON_NodePool *) cJSON_CreateNodePool(size_t slab_nodes);
+CJSON_PUBLIC(void) cJSON_DeleteNodePool(cJSON_NodePool *pool);
+CJSON_PUBLIC(cJSON *) cJSON_ParseWithContext(cJSON_ParseContext *context, const char *value, size_t buffer_length);
+CJSON_PUBLIC(void) cJSON_DeleteWithContext(const cJSON_ParseContext *context, cJSON *item);
+
+/* Event (SAX) parsing: cJSON_ParseSAX walks the JSON and calls the handler for every value instead of building items. */
+/* Strings and keys are only valid during their callback; NULL callbacks are skipped and a callback returning false stops the parse. */
+/* Returns true when the whole value was parsed, false on a syntax error (see cJSON_GetErrorPtr) or when a callback stopped it. */
+typedef struct cJSON_SAXHandler
+{
+    cJSON_bool (*start_object)(void *context);
+    cJSON_bool (*end_object)(void *context);
+    cJSON_bool (*start_array)(void *context);
+    cJSON_bool (*end_array)(void *context);
+    cJSON_bool (*key)(void *context, const char *key);
+    cJSON_bool (*string)(void *context, const char *value);
+    cJSON_bool (*number)(void *context, double value);
+    cJSON_bool (*boolean)(void *context, cJSON_bool value);
+    cJSON_bool (*null)(void *context);
+} cJSON_SAXHandler;
+CJSON_PUBLIC(cJSON_bool) cJSON_ParseSAX(const char *value, size_t buffer_length, const cJSON_SAXHandler *handler, void *context);
+
+/* Stream parsing: the same events for JSON that arrives in chunks, e.g. from a download. Chunks may split the input anywhere. */
+/* cJSON_FeedStreamParser returns false once the input is invalid or a callback stopped the parse; anything after the value is ignored. */
+/* cJSON_FinishStreamParser ends the input and returns true when a complete value was parsed. */
+typedef struct cJSON_StreamParser cJSON_StreamParser;
+CJSON_PUBLIC(cJSON_StreamParser *) cJSON_CreateStreamParser(const cJSON_SAXHandler *handler, void *context);
+CJSON_PUBLIC(cJSON_bool) cJSON_FeedStreamParser(cJSON_StreamParser *parser, const char *chunk, size_t length);
+CJSON_PUBLIC(cJSON_bool) cJSON_FinishStreamParser(cJSON_StreamParser *parser);
+CJSON_PUBLIC(void) cJSON_DeleteStreamParser(cJSON_StreamParser *parser);
+
+/* Path extraction: cJSON_ExtractPaths reads the values at a few paths in one pass without creating any items. */
+/* A path lists object names separated by '/' ("info/rate"); like cJSON_GetObjectItemCaseSensitive it matches exactly and follows the first member of a name. */
+/* values[i] gets the value at paths[i]: type stays cJSON_Invalid if there is none, a string is copied into the caller's valuestring buffer (truncated to valuestring_size). */
+/* Values no path leads to are only skimmed and reading stops once every path is settled, so the rest of the input is not validated. */
+typedef struct cJSON_PathValue
+{
+    int type;
+    int valueint;
+    double valuedouble;
+    char *valuestring;
+    size_t valuestring_size;
+} cJSON_PathValue;
+CJSON_PUBLIC(cJSON_bool) cJSON_ExtractPaths(const char *value, size_t buffer_length, const char * const *paths, size_t path_count, cJSON_PathValue *values);
+
+/* Tape documents: cJSON_ParseTape stores a whole document in one flat array of 8 byte entries plus one string buffer instead of a cJSON item per value. */
+/* A tape is read-only. Its values are cJSON_TapeItem handles, passed by value and valid until cJSON_DeleteTape; a handle whose tape is NULL means "no item". */
+/* The accessors mirror their cJSON counterparts: cJSON_TapeType returns cJSON_Object, cJSON_Number, ..., and lookups by name are case sensitive. */
+typedef struct cJSON_Tape cJSON_Tape;
+typedef struct cJSON_TapeItem
+{
+    const cJSON_Tape *tape;
+    unsigned int index; /* entry of the value */
+    unsigned int name; /* entry of its name inside an object, 0 otherwise */
+} cJSON_TapeItem;
+CJSON_PUBLIC(cJSON_Tape *) cJSON_ParseTape(const char *value, size_t buffer_length);
+CJSON_PUBLIC(void) cJSON_DeleteTape(cJSON_Tape *tape);
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeRoot(const cJSON_Tape *tape);
+CJSON_PUBLIC(int) cJSON_TapeType(const cJSON_TapeItem item);
+CJSON_PUBLIC(double) cJSON_TapeNumber(const cJSON_TapeItem item);
+CJSON_PUBLIC(const char *) cJSON_TapeString(const cJSON_TapeItem item);
+CJSON_PUBLIC(const char *) cJSON_TapeName(const cJSON_TapeItem item);
+CJSON_PUBLIC(int) cJSON_TapeSize(const cJSON_TapeItem item);
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeChild(const cJSON_TapeItem item);
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeNext(const cJSON_TapeItem item);
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeGetArrayItem(const cJSON_TapeItem array, int index);
+CJSON_PUBLIC(cJSON_TapeItem) cJSON_TapeGetObjectItem(const cJSON_TapeItem object, const char * const string);
+
 /* Render a cJSON entity to text for transfer/storage. */
 CJSON_PUBLIC(char *) cJSON_Print(const cJSON *item);
 /* Render a cJSON entity to text for transfer/storage without any formatting. */
@@ -161,6 +281,10 @@ CJSON_PUBLIC(char *) cJSON_PrintBuffered(const cJSON *item, int prebuffer, cJSON
 /* Render a cJSON entity to text using a buffer already allocated in memory with given length. Returns 1 on success and 0 on failure. */
 /* NOTE: cJSON is not always 100% accurate in estimating how much memory it will use, so to be safe allocate 5 bytes more than you actually need */
 CJSON_PUBLIC(cJSON_bool) cJSON_PrintPreallocated(cJSON *item, char *buffer, const int length, const cJSON_bool format);
+/* Render a cJSON entity through a sink (a file, socket, ring buffer, ...) instead of into one string. The text is collected in a buffer of CJSON_PRINT_CHUNK_SIZE bytes and handed to the sink */
+/* in order each time it is full, without a terminating '\0'; a string, raw value or indentation longer than that grows the buffer to fit. A sink returning false stops printing. Returns 1 when all of the text was written. */
+typedef cJSON_bool (*cJSON_PrintSink)(void *context, const char *data, size_t length);
+CJSON_PUBLIC(cJSON_bool) cJSON_PrintToSink(const cJSON *item, cJSON_bool format, cJSON_PrintSink sink, void *context);
 /* Delete a cJSON entity and all subentities. */
 CJSON_PUBLIC(void) cJSON_Delete(cJSON *item);
 
@@ -172,6 +296,14 @@ CJSON_PUBLIC(cJSON *) cJSON_GetArrayItem(const cJSON *array, int index);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItem(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON *) cJSON_GetObjectItemCaseSensitive(const cJSON * const object, const char * const string);
 CJSON_PUBLIC(cJSON_bool) cJSON_HasObjectItem(const cJSON *object, const char *string);
+/* Keep the children of an array in a contiguous index (see cJSON::index), making cJSON_GetArrayItem and cJSON_GetArraySize O(1).
+ * The index is heap allocated: on an array parsed into an arena, drop it before resetting the arena. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexArray(cJSON *array);
+/* Hash the keys of an object (see cJSON::index), so cJSON_GetObjectItem and its case sensitive variant don't walk the whole list.
+ * Worth it for objects with more than a dozen or so keys that are looked up repeatedly; heap allocated like the index of an array. */
+CJSON_PUBLIC(cJSON_bool) cJSON_IndexObject(cJSON *object);
+/* Release the index of an object or array (see cJSON::index); lookups fall back to walking the list. */
+CJSON_PUBLIC(void) cJSON_DropIndex(cJSON *item);
 /* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when cJSON_Parse() returns 0. 0 when cJSON_Parse() succeeds. */
 CJSON_PUBLIC(const char *) cJSON_GetErrorPtr(void);
 
@@ -288,6 +420,8 @@ CJSON_PUBLIC(char*) cJSON_SetValuestring(cJSON *object, const char *valuestring)
 
 /* Macro for iterating over an array or object */
 #define cJSON_ArrayForEach(element, array) for(element = (array != NULL) ? (array)->child : NULL; element != NULL; element = element->next)
+/* Macro for iterating over the values of a tape object or array */
+#define cJSON_TapeForEach(element, container) for(element = cJSON_TapeChild(container); element.tape != NULL; element = cJSON_TapeNext(element))
 
 /* malloc/free objects using the malloc/free functions that have been set with cJSON_InitHooks */
 CJSON_PUBLIC(void *) cJSON_malloc(size_t size);
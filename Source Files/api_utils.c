@@ -4,47 +4,73 @@
 #include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
 #include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
 #include <stddef.h> 	// Standard header defining types related to pointers and offsets, including NULL pointer
+#include <ctype.h>      // Library for character handling functions like isdigit, isalpha, etc.
+#include "cJSON.h"      // Header for cJSON, a lightweight JSON parsing library
 #include "api_utils.h"  // Header file containing API-related constants, structures, and functions
 
 
-// Define the variable to store an array of supported currency codes
-int numberOfCurrencies = 0; // Initializing the variable to track the count of supported currency codes to zero
-char** supportedCurrencies; // This variable will hold the array of supported currency codes
+// Function to get the base URL of the FX Rates API
+// Returns the value of TCONVERT_API_URL when set, otherwise the public API endpoint
+const char* getApiBaseUrl() {
+    const char* override = getenv(API_BASE_URL_ENV);
+    if (override != NULL && *override != '\0') {
+        return override;
+    }
+    return API_BASE_URL;
+}
 
 
-// Callback function used to handle API response data retrieval
-// Appends the received 'contents' to the user-provided memory 'userp'
-// Size of 'contents' data is 'size * nmemb' bytes
+// Callback function used during an API request to parse the response while it downloads
+// Feeds the 'ptr' data to the cJSON_StreamParser 'data', so the body is never buffered whole
+// A parse error is not reported here: the parser ignores the rest of the body and the caller sees it fail when finishing
 // Returns the total size of the received data
-size_t writeCallbackForConversion(void* contents, size_t size, size_t nmemb, void* userp) {
-    size_t realsize = size * nmemb; // Calculate the actual size of the received data
-    char* data = (char*)userp; // Cast user-provided memory to char pointer
-    strcat(data, (char*)contents); // Append the received data to the user-provided memory
-    return realsize; // Return the total size of the received data
+size_t writeCallbackForStream(void *ptr, size_t size, size_t nmemb, void *data) {
+    size_t real_size = size * nmemb; // Calculate the actual size of the received data
+    cJSON_FeedStreamParser((cJSON_StreamParser *)data, (const char *)ptr, real_size);
+    return real_size; // Return the total size of the received data
 }
 
 
-// Callback function used during an API request to write received data
-// Appends the 'ptr' data to the 'MemoryStruct' object 'data' and updates its size
-// 'size' indicates the size of each data element, 'nmemb' is the number of elements received
-// Returns the total size of the received data
-size_t writeCallbackForCurrency(void *ptr, size_t size, size_t nmemb, void *data) {
-    size_t real_size = size * nmemb; // Calculate the actual size of the received data
-    struct MemoryStruct *mem = (struct MemoryStruct *)data; // Cast user-provided data to MemoryStruct pointer
+// Function to copy the value of a header line if it carries the header 'name'
+// Header names are case-insensitive; surrounding whitespace and the trailing CRLF are dropped
+static void copyHeaderValue(const char *line, size_t length, const char *name, char *value, size_t valueSize) {
+    size_t nameLength = strlen(name);
+    if (length <= nameLength || line[nameLength] != ':') {
+        return;
+    }
+    for (size_t i = 0; i < nameLength; ++i) {
+        if (tolower((unsigned char)line[i]) != tolower((unsigned char)name[i])) {
+            return;
+        }
+    }
 
-    // Reallocate memory to store the received data along with existing data
-    mem->memory = realloc(mem->memory, mem->size + real_size + 1);
+    // Trim the value
+    size_t start = nameLength + 1;
+    size_t end = length;
+    while (start < end && isspace((unsigned char)line[start])) {
+        start++;
+    }
+    while (end > start && isspace((unsigned char)line[end - 1])) {
+        end--;
+    }
 
-    if (mem->memory == NULL) {
-        // Handle out-of-memory error
-        fprintf(stderr, "\n\t\t\t\t\t\t\tNot enough memory (realloc returned NULL)\n");
-        return 0; // Return 0 to indicate failure
+    // Ignore values that do not fit rather than storing a truncated validator
+    if (end - start < valueSize) {
+        memcpy(value, line + start, end - start);
+        value[end - start] = '\0';
     }
+}
 
-    // Copy the received data to the end of the existing memory block
-    memcpy(&(mem->memory[mem->size]), ptr, real_size);
-    mem->size += real_size;
-    mem->memory[mem->size] = 0; // Add null terminator to ensure proper string termination
 
-    return real_size; // Return the total size of the received data
-}
\ No newline at end of file
+// Callback function used during an API request to capture cache validators
+// libcurl calls it once per response header line; 'userdata' points to a CatalogValidators struct
+// Returns the number of bytes handled, as libcurl requires
+size_t headerCallbackForValidators(char *buffer, size_t size, size_t nitems, void *userdata) {
+    size_t length = size * nitems; // Length of the header line (not null-terminated)
+    CatalogValidators *validators = (CatalogValidators *)userdata;
+
+    copyHeaderValue(buffer, length, "ETag", validators->etag, sizeof(validators->etag));
+    copyHeaderValue(buffer, length, "Last-Modified", validators->lastModified, sizeof(validators->lastModified));
+
+    return length;
+}
@@ -0,0 +1,363 @@
+// batch_conversion.c - Source file for the non-interactive batch conversion mode
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <ctype.h>      // Library for character handling functions like isdigit, isalpha, etc.
+#include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
+#include <windows.h>    // Library providing functions for Windows API and system-related functions
+#include "currency_catalog.h" // Header file for the currency catalog object
+#include "currency_operations.h" // Header file for currency operations functionality
+#include "currency_utils.h" // Header file providing utility functions for currency handling
+#include "date_utils.h" // Header file containing utility functions for handling dates and times
+#include "rate_engine.h" // Header file for the local cross-rate engine
+#include "batch_conversion.h" // Header file for the non-interactive batch conversion mode
+
+
+// Distinct dates of the window being converted
+static char windowDates[BATCH_WINDOW_ROWS][11];
+static bool windowDateFailed[BATCH_WINDOW_ROWS]; // Set for the dates whose rates could not be fetched
+static short windowDateTable[BATCH_DATE_TABLE_SIZE]; // Open-addressing table of date index + 1, 0 for an empty slot
+static int windowDateCount = 0;
+
+
+// Function to split a row into fields at 'delimiter', trimming surrounding spaces
+// Returns the number of fields found (the row is modified in place)
+static int splitBatchRow(char* row, char delimiter, char* fields[BATCH_FIELD_COUNT]) {
+    int count = 0;
+    char* field = row;
+
+    while (count < BATCH_FIELD_COUNT) {
+        char* end = strchr(field, delimiter);
+        if (end != NULL) {
+            *end = '\0';
+        }
+
+        // Trim the field
+        while (isspace((unsigned char)*field)) {
+            field++;
+        }
+        size_t length = strlen(field);
+        while (length > 0 && isspace((unsigned char)field[length - 1])) {
+            field[--length] = '\0';
+        }
+        fields[count++] = field;
+
+        if (end == NULL) {
+            break;
+        }
+        field = end + 1;
+    }
+    return count;
+}
+
+
+// Function to parse a positive amount
+static bool parseBatchAmount(const char* text, double* amount) {
+    char* end;
+    *amount = strtod(text, &end);
+    return end != text && *end == '\0' && *amount > 0;
+}
+
+
+// Function to resolve a currency code given in any letter case
+static CurrencyId parseBatchCurrency(const char* text) {
+    char code[CURRENCY_CODE_SIZE];
+    size_t length = strlen(text);
+
+    if (length == 0 || length >= sizeof(code)) {
+        return INVALID_CURRENCY_ID;
+    }
+    for (size_t i = 0; i <= length; ++i) {
+        code[i] = (char)toupper((unsigned char)text[i]);
+    }
+    return getCurrencyId(code);
+}
+
+
+// Function to get the date whose rates a row uses
+// An empty date or 'today' means the current UTC date, and future dates are clamped to it
+// Returns NULL if the date is malformed or does not exist
+static const char* resolveBatchDate(const char* field, const char* currentDate) {
+    char canonical[11];
+
+    if (field[0] == '\0' || strcmp(field, "today") == 0) {
+        return currentDate;
+    }
+    if (!validateDateFormat(field)) {
+        return NULL;
+    }
+
+    // getDayNumber() rolls an impossible date such as 2023-02-30 over into a real one
+    formatDayNumber(getDayNumber(field), canonical);
+    if (strcmp(canonical, field) != 0) {
+        return NULL;
+    }
+    return strcmp(field, currentDate) < 0 ? field : currentDate;
+}
+
+
+// Function to find a date among the distinct dates of the window, adding it when 'add' is set
+// Returns the index of the date, or -1 if it is not there
+static int findWindowDate(const char* date, bool add) {
+    // Hash the date (FNV-1a) and probe linearly for it
+    unsigned int hash = 2166136261u;
+    for (const char* c = date; *c != '\0'; ++c) {
+        hash = (hash ^ (unsigned char)*c) * 16777619u;
+    }
+    unsigned int slot = hash & (BATCH_DATE_TABLE_SIZE - 1);
+    while (windowDateTable[slot] != 0 && strcmp(windowDates[windowDateTable[slot] - 1], date) != 0) {
+        slot = (slot + 1) & (BATCH_DATE_TABLE_SIZE - 1);
+    }
+
+    if (windowDateTable[slot] == 0) {
+        if (!add) {
+            return -1;
+        }
+        strcpy(windowDates[windowDateCount], date);
+        windowDateFailed[windowDateCount] = false;
+        windowDateTable[slot] = (short)++windowDateCount;
+    }
+    return windowDateTable[slot] - 1;
+}
+
+
+// Function to check whether the rates of a date already failed to download for this window
+// Rows of such a date are reported without going back to the network for each of them
+static bool isWindowDateFailed(const char* date) {
+    int index = findWindowDate(date, false);
+    return index >= 0 && windowDateFailed[index];
+}
+
+
+// Function to split a row and check its fields
+// Missing trailing fields are returned as empty
+// Returns NULL if the row is valid, otherwise the reason it is not
+static const char* parseBatchRow(char* row, char delimiter, const char* currentDate, char* fields[BATCH_FIELD_COUNT],
+                                 double* amount, CurrencyId* fromId, CurrencyId* toId, const char** date) {
+    int count = splitBatchRow(row, delimiter, fields);
+    for (int i = count; i < BATCH_FIELD_COUNT; ++i) {
+        fields[i] = "";
+    }
+
+    if (count < 3) {
+        return "too few fields (expected amount from to [date])";
+    }
+    if (!parseBatchAmount(fields[0], amount)) {
+        return "invalid amount";
+    }
+    if ((*fromId = parseBatchCurrency(fields[1])) == INVALID_CURRENCY_ID) {
+        return "invalid 'from' currency code";
+    }
+    if ((*toId = parseBatchCurrency(fields[2])) == INVALID_CURRENCY_ID) {
+        return "invalid 'to' currency code";
+    }
+    if ((*date = resolveBatchDate(fields[3], currentDate)) == NULL) {
+        return "invalid date (expected YYYY-MM-DD)";
+    }
+    return NULL;
+}
+
+
+// Function to convert one row and write its result
+// The output repeats the normalized input followed by the rate, the converted amount and "ok" or the reason it failed
+// Returns true if the row was converted
+static bool convertBatchRow(char* row, char delimiter, const char* currentDate, FILE* output) {
+    char* fields[BATCH_FIELD_COUNT];
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    double amount = 0;
+    double exchangeRate = 0;
+    CurrencyId fromId = INVALID_CURRENCY_ID;
+    CurrencyId toId = INVALID_CURRENCY_ID;
+    const char* date = NULL;
+
+    const char* error = parseBatchRow(row, delimiter, currentDate, fields, &amount, &fromId, &toId, &date);
+    if (error == NULL && (isWindowDateFailed(date) || !getCrossRate(fromId, toId, date, &exchangeRate))) {
+        error = "no exchange rate available";
+    }
+
+    if (error != NULL) {
+        fprintf(output, "%s%c%s%c%s%c%s%c%c%c%s\n", fields[0], delimiter, fields[1], delimiter, fields[2], delimiter,
+                fields[3], delimiter, delimiter, delimiter, error);
+        return false;
+    }
+
+    int fromDigits = getCurrencyMinorUnits(catalog, fromId);
+    int toDigits = getCurrencyMinorUnits(catalog, toId);
+    fprintf(output, "%.*lf%c%s%c%s%c%s%c%.10g%c%.*lf%cok\n", fromDigits, amount, delimiter, getCurrencyCode(catalog, fromId), delimiter,
+            getCurrencyCode(catalog, toId), delimiter, date, delimiter, exchangeRate, delimiter, toDigits,
+            convertCurrency(amount, exchangeRate), delimiter);
+    return true;
+}
+
+
+// Function to pick the delimiter from the first row (tab if it has one, otherwise comma) and write the output header
+static char writeBatchHeader(const char* firstRow, FILE* output) {
+    char delimiter = strchr(firstRow, '\t') != NULL ? '\t' : ',';
+    fprintf(output, "amount%cfrom%cto%cdate%crate%cconverted%cstatus\n", delimiter, delimiter, delimiter, delimiter,
+            delimiter, delimiter);
+    return delimiter;
+}
+
+
+// Function to check whether the first row is a header rather than data
+// Only a row whose amount and both currency codes are unreadable is taken for one, so a mistyped amount is still reported
+static bool isBatchHeader(const char* firstRow, char delimiter) {
+    char row[BATCH_LINE_SIZE];
+    char* fields[BATCH_FIELD_COUNT];
+    double amount;
+
+    strcpy(row, firstRow);
+    int count = splitBatchRow(row, delimiter, fields);
+    return !parseBatchAmount(fields[0], &amount)
+        && (count < 2 || parseBatchCurrency(fields[1]) == INVALID_CURRENCY_ID)
+        && (count < 3 || parseBatchCurrency(fields[2]) == INVALID_CURRENCY_ID);
+}
+
+
+// Function to download the rates of every date used in a window of rows
+// Only the dates of rows that will be converted count; the distinct dates are handed to the rate engine together,
+// so their downloads run concurrently
+// The dates whose download fails are remembered in windowDateFailed
+static void prefetchBatchDates(char window[][BATCH_LINE_SIZE], int count, char delimiter, const char* currentDate) {
+    const char* pending[BATCH_WINDOW_ROWS];
+
+    memset(windowDateTable, 0, sizeof(windowDateTable));
+    windowDateCount = 0;
+
+    for (int i = 0; i < count; ++i) {
+        char row[BATCH_LINE_SIZE];
+        char* fields[BATCH_FIELD_COUNT];
+        double amount;
+        CurrencyId fromId, toId;
+        const char* date;
+
+        if (window[i][0] == '\0') {
+            continue; // Row that was too long
+        }
+        strcpy(row, window[i]);
+        if (parseBatchRow(row, delimiter, currentDate, fields, &amount, &fromId, &toId, &date) == NULL) {
+            findWindowDate(date, true);
+        }
+    }
+
+    for (int i = 0; i < windowDateCount; ++i) {
+        pending[i] = windowDates[i];
+    }
+    prefetchRateVectors(pending, windowDateCount, windowDateFailed);
+}
+
+
+// Function to run a batch conversion
+// Rows are read in windows of BATCH_WINDOW_ROWS: the rates of a window's dates are fetched together, then its
+// results are written in input order, so memory use does not depend on the size of the input
+int runBatchConversion(const char* inputPath, const char* outputPath) {
+    static char window[BATCH_WINDOW_ROWS][BATCH_LINE_SIZE]; // Rows read ahead; an empty row marks one that was too long
+    char currentDate[11];
+    char delimiter = '\0'; // Taken from the first row, when the output header is written
+    unsigned long rows = 0;
+    unsigned long failures = 0;
+    bool endOfInput = false;
+    LARGE_INTEGER frequency, start, end;
+
+    if (getActiveCatalog() == NULL) {
+        fprintf(stderr, "Error: No currency catalog is available; cannot run the batch.\n");
+        return EXIT_FAILURE;
+    }
+
+    bool readsStdin = strcmp(inputPath, BATCH_STDIO_PATH) == 0;
+    bool writesStdout = strcmp(outputPath, BATCH_STDIO_PATH) == 0;
+    FILE* input = readsStdin ? stdin : fopen(inputPath, "r");
+    if (input == NULL) {
+        fprintf(stderr, "Error: Cannot open batch input '%s'.\n", inputPath);
+        return EXIT_FAILURE;
+    }
+    FILE* output = writesStdout ? stdout : fopen(outputPath, "w");
+    if (output == NULL) {
+        fprintf(stderr, "Error: Cannot open batch output '%s'.\n", outputPath);
+        if (!readsStdin) {
+            fclose(input);
+        }
+        return EXIT_FAILURE;
+    }
+    setvbuf(output, NULL, _IOFBF, BATCH_OUTPUT_BUFFER_SIZE);
+
+    getCurrentDateUTC(currentDate); // One date for the whole run, so 'today' rows agree with each other
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&start);
+
+    while (!endOfInput) {
+        int count = 0;
+
+        // Read ahead up to a full window of rows
+        while (count < BATCH_WINDOW_ROWS) {
+            char* row = window[count];
+            if (fgets(row, BATCH_LINE_SIZE, input) == NULL) {
+                endOfInput = true;
+                break;
+            }
+            size_t length = strlen(row);
+
+            // Rows longer than the buffer are skipped whole and reported
+            if (length > 0 && row[length - 1] != '\n' && !feof(input)) {
+                int character;
+                if (delimiter == '\0') {
+                    delimiter = writeBatchHeader(row, output);
+                }
+                while ((character = fgetc(input)) != '\n' && character != EOF) {
+                    // Discard the rest of the row
+                }
+                row[0] = '\0';
+                count++;
+                continue;
+            }
+
+            // Strip the line ending and skip blank rows
+            while (length > 0 && (row[length - 1] == '\n' || row[length - 1] == '\r')) {
+                row[--length] = '\0';
+            }
+            if (strspn(row, " \t") == length) {
+                continue;
+            }
+
+            // The first row fixes the delimiter of the output header and is skipped if it is a header itself
+            if (delimiter == '\0') {
+                delimiter = writeBatchHeader(row, output);
+                if (isBatchHeader(row, delimiter)) {
+                    continue;
+                }
+            }
+            count++;
+        }
+
+        prefetchBatchDates(window, count, delimiter, currentDate);
+
+        // Convert the window in input order
+        for (int i = 0; i < count; ++i) {
+            rows++;
+            if (window[i][0] == '\0') {
+                fprintf(output, "%c%c%c%c%c%crow longer than %d characters\n", delimiter, delimiter, delimiter, delimiter,
+                        delimiter, delimiter, BATCH_LINE_SIZE - 2);
+                failures++;
+            } else if (!convertBatchRow(window[i], delimiter, currentDate, output)) {
+                failures++;
+            }
+        }
+    }
+
+    fflush(output);
+    QueryPerformanceCounter(&end);
+
+    double seconds = (double)(end.QuadPart - start.QuadPart) / (double)frequency.QuadPart;
+    fprintf(stderr, "Converted %lu of %lu rows (%lu failed) in %.3lf s, %.0lf rows/sec\n",
+            rows - failures, rows, failures, seconds, seconds > 0 ? rows / seconds : 0.0);
+
+    if (!readsStdin) {
+        fclose(input);
+    }
+    if (!writesStdout) {
+        fclose(output);
+    }
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
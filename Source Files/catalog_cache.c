@@ -0,0 +1,306 @@
+// catalog_cache.c - Source file for the on-disk currency catalog cache
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <time.h>       // Library for date and time functions like time, localtime, etc.
+#include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
+#include <windows.h>    // Library providing functions for Windows API and system-related functions
+#include "api_utils.h"  // Header file containing API-related constants, structures, and functions
+#include "currency_operations.h" // Header file for currency operations functionality
+#include "currency_catalog.h" // Header file for the currency catalog object
+#include "catalog_cache.h" // Header file for the on-disk currency catalog cache
+#include "utilities.h" // Header file for miscellaneous utility functions
+
+
+// Layout of the cache file (all integers little-endian); the catalog arrays are stored
+// as-is, so loading is a handful of memcpy calls into a freshly created catalog:
+//   4 bytes  magic "TCVC"
+//   2 bytes  layout version
+//   2 bytes  number of currencies (N)
+//   8 bytes  time the catalog was fetched (seconds since the epoch)
+//   4 bytes  size of the name arena in bytes (A)
+//   CATALOG_VALIDATOR_SIZE bytes    ETag of the response (null-padded)
+//   CATALOG_VALIDATOR_SIZE bytes    Last-Modified of the response (null-padded)
+//   N * CURRENCY_CODE_SIZE bytes    code slots
+//   N * CURRENCY_SYMBOL_SIZE bytes  symbol slots
+//   N bytes                         minor units
+//   N * 4 bytes                     name offsets
+//   A bytes                         name arena
+#define CATALOG_CACHE_HEADER_SIZE (20 + 2 * CATALOG_VALIDATOR_SIZE) // Size of the fixed part of the cache file
+#define CATALOG_CACHE_FETCHED_AT_OFFSET 8 // Position of the fetch time inside the header
+#define CATALOG_CACHE_MAX_FILE_SIZE (256 * 1024) // Upper bound accepted when reading a cache file
+
+
+// State shared between the menu thread and the background refresh
+static volatile LONG refreshInFlight = 0; // Set while a background refresh is running
+static CurrencyCatalog* volatile pendingCatalog = NULL; // Catalog produced by a background refresh, not yet installed
+static volatile LONG revalidationPending = 0; // Set when a background refresh got 304 Not Modified
+static time_t revalidatedAt = 0; // Time of that 304, valid once 'revalidationPending' is set
+static time_t catalogValidatedAt = 0; // Last time the active catalog was confirmed current by the server
+
+
+// Function to read a little-endian unsigned integer of 'size' bytes
+static unsigned long long readLittleEndian(const unsigned char* bytes, int size) {
+    unsigned long long value = 0;
+    for (int i = size - 1; i >= 0; --i) {
+        value = (value << 8) | bytes[i];
+    }
+    return value;
+}
+
+
+// Function to write a little-endian unsigned integer of 'size' bytes
+static void writeLittleEndian(unsigned char* bytes, unsigned long long value, int size) {
+    for (int i = 0; i < size; ++i) {
+        bytes[i] = (unsigned char)(value & 0xFF);
+        value >>= 8;
+    }
+}
+
+
+// Function to load the cached catalog from disk
+// The whole file is read with a single fread and copied straight into a catalog, so a warm start costs microseconds
+// Returns NULL if the file is missing, truncated or written by an incompatible version
+CurrencyCatalog* loadCatalogCache(const char* path) {
+    unsigned char* data;
+    long fileSize;
+    int count;
+    size_t arenaSize;
+
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return NULL; // No cache yet
+    }
+
+    // Read the whole file in one go
+    fseek(file, 0, SEEK_END);
+    fileSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (fileSize < CATALOG_CACHE_HEADER_SIZE || fileSize > CATALOG_CACHE_MAX_FILE_SIZE) {
+        fclose(file);
+        return NULL;
+    }
+
+    data = malloc(fileSize);
+    if (data == NULL || fread(data, 1, fileSize, file) != (size_t)fileSize) {
+        free(data);
+        fclose(file);
+        return NULL;
+    }
+    fclose(file);
+
+    // Check the signature, layout version and total size
+    count = (int)readLittleEndian(data + 6, 2);
+    arenaSize = (size_t)readLittleEndian(data + 16, 4);
+    if (memcmp(data, CATALOG_CACHE_MAGIC, 4) != 0 || readLittleEndian(data + 4, 2) != CATALOG_CACHE_VERSION ||
+        (size_t)fileSize != CATALOG_CACHE_HEADER_SIZE + (size_t)count * (CURRENCY_CODE_SIZE + CURRENCY_SYMBOL_SIZE + 1 + 4) + arenaSize) {
+        free(data);
+        return NULL;
+    }
+
+    CurrencyCatalog* catalog = createCurrencyCatalog(count, arenaSize);
+    if (catalog == NULL) {
+        free(data);
+        return NULL;
+    }
+    catalog->fetchedAt = (time_t)readLittleEndian(data + CATALOG_CACHE_FETCHED_AT_OFFSET, 8);
+    memcpy(catalog->validators.etag, data + 20, CATALOG_VALIDATOR_SIZE);
+    memcpy(catalog->validators.lastModified, data + 20 + CATALOG_VALIDATOR_SIZE, CATALOG_VALIDATOR_SIZE);
+
+    // Copy the arrays into place
+    const unsigned char* cursor = data + CATALOG_CACHE_HEADER_SIZE;
+    memcpy(catalog->codes, cursor, (size_t)count * CURRENCY_CODE_SIZE);
+    cursor += (size_t)count * CURRENCY_CODE_SIZE;
+    memcpy(catalog->symbols, cursor, (size_t)count * CURRENCY_SYMBOL_SIZE);
+    cursor += (size_t)count * CURRENCY_SYMBOL_SIZE;
+    memcpy(catalog->minorUnits, cursor, (size_t)count);
+    cursor += count;
+    for (int i = 0; i < count; ++i) {
+        catalog->nameOffsets[i] = (uint32_t)readLittleEndian(cursor + (size_t)i * 4, 4);
+    }
+    cursor += (size_t)count * 4;
+    memcpy(catalog->nameArena, cursor, arenaSize);
+    catalog->nameArenaUsed = arenaSize;
+    free(data);
+
+    // Reject slots that are not null-terminated or names that point outside the arena
+    bool valid = catalog->nameArena[arenaSize - 1] == '\0' &&
+                 catalog->validators.etag[CATALOG_VALIDATOR_SIZE - 1] == '\0' &&
+                 catalog->validators.lastModified[CATALOG_VALIDATOR_SIZE - 1] == '\0';
+    for (int i = 0; valid && i < count; ++i) {
+        valid = catalog->codes[i][0] != '\0' && catalog->codes[i][CURRENCY_CODE_SIZE - 1] == '\0' &&
+                catalog->symbols[i][CURRENCY_SYMBOL_SIZE - 1] == '\0' && catalog->nameOffsets[i] < arenaSize;
+        if (valid) {
+            indexCatalogCode(catalog, (CurrencyId)i);
+        }
+    }
+    if (!valid) {
+        freeCurrencyCatalog(catalog);
+        return NULL;
+    }
+    return catalog;
+}
+
+
+// Function to save the catalog to disk
+// Writes to a temporary file first and renames it over the cache so readers never see a partial file
+bool saveCatalogCache(const char* path, const CurrencyCatalog* catalog) {
+    unsigned char header[CATALOG_CACHE_HEADER_SIZE];
+    char temporaryPath[260];
+    bool success = true;
+    size_t count = (size_t)catalog->count;
+
+    snprintf(temporaryPath, sizeof(temporaryPath), "%s.tmp", path);
+    FILE* file = fopen(temporaryPath, "wb");
+    if (file == NULL) {
+        return false;
+    }
+
+    // Write the fixed-size header
+    memset(header, 0, sizeof(header));
+    memcpy(header, CATALOG_CACHE_MAGIC, 4);
+    writeLittleEndian(header + 4, CATALOG_CACHE_VERSION, 2);
+    writeLittleEndian(header + 6, count, 2);
+    writeLittleEndian(header + CATALOG_CACHE_FETCHED_AT_OFFSET, (unsigned long long)catalog->fetchedAt, 8);
+    writeLittleEndian(header + 16, catalog->nameArenaUsed, 4);
+    memcpy(header + 20, catalog->validators.etag, CATALOG_VALIDATOR_SIZE);
+    memcpy(header + 20 + CATALOG_VALIDATOR_SIZE, catalog->validators.lastModified, CATALOG_VALIDATOR_SIZE);
+    success = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    // Write the arrays in the order the loader expects them
+    success = success &&
+              fwrite(catalog->codes, CURRENCY_CODE_SIZE, count, file) == count &&
+              fwrite(catalog->symbols, CURRENCY_SYMBOL_SIZE, count, file) == count &&
+              fwrite(catalog->minorUnits, 1, count, file) == count;
+    for (size_t i = 0; success && i < count; ++i) {
+        unsigned char offset[4];
+        writeLittleEndian(offset, catalog->nameOffsets[i], 4);
+        success = fwrite(offset, 1, sizeof(offset), file) == sizeof(offset);
+    }
+    success = success && fwrite(catalog->nameArena, 1, catalog->nameArenaUsed, file) == catalog->nameArenaUsed;
+
+    if (fclose(file) != 0) {
+        success = false;
+    }
+
+    // Atomically replace the previous cache file
+    if (success) {
+        success = MoveFileExA(temporaryPath, path, MOVEFILE_REPLACE_EXISTING) != 0;
+    }
+    if (!success) {
+        remove(temporaryPath);
+    }
+    return success;
+}
+
+
+// Function to record a successful revalidation in the cache file
+// Only the fetch time in the header is rewritten; the catalog itself is unchanged
+bool touchCatalogCache(const char* path, time_t validatedAt) {
+    unsigned char stamp[8];
+
+    FILE* file = fopen(path, "r+b");
+    if (file == NULL) {
+        return false;
+    }
+
+    writeLittleEndian(stamp, (unsigned long long)validatedAt, sizeof(stamp));
+    bool success = fseek(file, CATALOG_CACHE_FETCHED_AT_OFFSET, SEEK_SET) == 0 &&
+                   fwrite(stamp, 1, sizeof(stamp), file) == sizeof(stamp);
+
+    if (fclose(file) != 0) {
+        success = false;
+    }
+    return success;
+}
+
+
+// Background thread body: revalidates or downloads the catalog, persists it and hands it to the menu thread
+// 'parameter' is a heap copy of the active catalog's validators, owned by this thread
+static DWORD WINAPI refreshCatalogThread(LPVOID parameter) {
+    CatalogValidators* validators = (CatalogValidators*)parameter;
+    bool notModified;
+
+    CurrencyCatalog* catalog = downloadCurrencyCatalog(validators, &notModified);
+    if (catalog != NULL) {
+        saveCatalogCache(CATALOG_CACHE_FILE, catalog);
+
+        // Publish the result; the menu thread installs it at its next iteration
+        freeCurrencyCatalog(InterlockedExchangePointer((void* volatile*)&pendingCatalog, catalog));
+    } else if (notModified) {
+        // The server confirmed the catalog is current: restart its TTL without replacing it
+        revalidatedAt = time(NULL);
+        touchCatalogCache(CATALOG_CACHE_FILE, revalidatedAt);
+        InterlockedExchange(&revalidationPending, 1);
+    }
+
+    free(validators);
+    InterlockedExchange(&refreshInFlight, 0);
+    return 0;
+}
+
+
+// Function to load the catalog once at startup
+// A cached catalog is used as-is (even if stale, it is revalidated in the background);
+// the API is only contacted synchronously when no usable cache file exists
+void initCurrencyCatalog() {
+    CurrencyCatalog* catalog = loadCatalogCache(CATALOG_CACHE_FILE);
+    if (catalog == NULL) {
+        catalog = downloadCurrencyCatalog(NULL, NULL);
+        if (catalog != NULL) {
+            saveCatalogCache(CATALOG_CACHE_FILE, catalog);
+        }
+    }
+    if (catalog != NULL) {
+        swapActiveCatalog(catalog);
+    }
+
+    refreshCurrencyCatalogIfStale();
+}
+
+
+// Function to keep the catalog fresh without blocking the menu
+// Installs the result of a completed background refresh and, once the TTL has expired,
+// starts a new conditional refresh on a worker thread; the caller never waits on the network
+void refreshCurrencyCatalogIfStale() {
+    // Pick up a catalog downloaded in the background; the previous generation is freed by the swap
+    CurrencyCatalog* refreshed = InterlockedExchangePointer((void* volatile*)&pendingCatalog, NULL);
+    if (refreshed != NULL) {
+        swapActiveCatalog(refreshed);
+    }
+
+    // Pick up a revalidation of the active catalog
+    if (InterlockedExchange(&revalidationPending, 0) != 0) {
+        catalogValidatedAt = revalidatedAt;
+    }
+
+    // Nothing to do while the catalog is still fresh
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    if (catalog != NULL) {
+        time_t validatedAt = catalog->fetchedAt > catalogValidatedAt ? catalog->fetchedAt : catalogValidatedAt;
+        if (time(NULL) - validatedAt < getEnvSeconds(CATALOG_CACHE_TTL_ENV, CATALOG_CACHE_TTL_SECONDS)) {
+            return;
+        }
+    }
+
+    // Start a refresh unless one is already running
+    if (InterlockedCompareExchange(&refreshInFlight, 1, 0) != 0) {
+        return;
+    }
+
+    // Hand the worker its own copy of the validators; it must not touch the active catalog
+    CatalogValidators* validators = calloc(1, sizeof(CatalogValidators));
+    if (validators != NULL && catalog != NULL) {
+        *validators = catalog->validators;
+    }
+
+    HANDLE thread = validators != NULL ? CreateThread(NULL, 0, refreshCatalogThread, validators, 0, NULL) : NULL;
+    if (thread == NULL) {
+        free(validators);
+        InterlockedExchange(&refreshInFlight, 0); // Try again on the next iteration
+    } else {
+        CloseHandle(thread); // The thread runs detached
+    }
+}
@@ -0,0 +1,181 @@
+// currency_catalog.c - Source file for the currency catalog object
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
+#include <windows.h>    // Library providing functions for Windows API and system-related functions
+#include "api_utils.h"  // Header file containing API-related constants, structures, and functions
+#include "currency_catalog.h" // Header file for the currency catalog object
+
+
+// The catalog every lookup reads from; replaced as a whole on refresh
+static CurrencyCatalog* volatile activeCatalog = NULL;
+static unsigned long catalogGeneration = 0; // Generation number of the most recently installed catalog
+
+
+// Function to allocate an empty catalog
+// The parallel arrays and the name arena are carved out of the same block as the struct,
+// widest element type first so every array stays naturally aligned
+CurrencyCatalog* createCurrencyCatalog(int count, size_t nameArenaSize) {
+    if (count <= 0 || count > MAX_CURRENCIES || nameArenaSize == 0) {
+        return NULL; // Refuse empty or implausibly large catalogs
+    }
+
+    size_t arraysSize = (size_t)count * (sizeof(uint32_t) + CURRENCY_CODE_SIZE + CURRENCY_SYMBOL_SIZE + sizeof(uint8_t));
+    CurrencyCatalog* catalog = calloc(1, sizeof(CurrencyCatalog) + arraysSize + nameArenaSize);
+    if (catalog == NULL) {
+        return NULL;
+    }
+
+    unsigned char* cursor = (unsigned char*)(catalog + 1);
+    catalog->nameOffsets = (uint32_t*)cursor;
+    cursor += (size_t)count * sizeof(uint32_t);
+    catalog->codes = (char (*)[CURRENCY_CODE_SIZE])cursor;
+    cursor += (size_t)count * CURRENCY_CODE_SIZE;
+    catalog->symbols = (char (*)[CURRENCY_SYMBOL_SIZE])cursor;
+    cursor += (size_t)count * CURRENCY_SYMBOL_SIZE;
+    catalog->minorUnits = cursor;
+    cursor += (size_t)count;
+    catalog->nameArena = (char*)cursor;
+
+    catalog->count = count;
+    catalog->nameArenaSize = nameArenaSize;
+    return catalog;
+}
+
+
+// Function to pack an ISO 4217 style code into a 15-bit index
+// Each of the three uppercase letters takes 5 bits: ((c0 - 'A') << 10) | ((c1 - 'A') << 5) | (c2 - 'A')
+// Returns -1 if the code is not exactly three uppercase letters
+int packCurrencyCode(const char* code) {
+    unsigned first = (unsigned char)code[0] - 'A';
+    if (first >= 26) {
+        return -1;
+    }
+    unsigned second = (unsigned char)code[1] - 'A';
+    if (second >= 26) {
+        return -1;
+    }
+    unsigned third = (unsigned char)code[2] - 'A';
+    if (third >= 26 || code[3] != '\0') {
+        return -1;
+    }
+    return (int)((first << 10) | (second << 5) | third);
+}
+
+
+// Function to add a currency code to the packed index
+// If a code appears twice the first ID keeps it
+void indexCatalogCode(CurrencyCatalog* catalog, CurrencyId id) {
+    int packed = packCurrencyCode(catalog->codes[id]);
+    if (packed >= 0 && catalog->codeIndex[packed] == 0) {
+        catalog->codeIndex[packed] = (uint16_t)(id + 1);
+    }
+}
+
+
+// Function to fill one entry of a catalog under construction
+// The name is appended to the arena, so entries must be added in ID order
+// A symbol that does not fit its slot is replaced by the currency code
+// Returns false if the ID is out of range or the code or name does not fit
+bool setCatalogEntry(CurrencyCatalog* catalog, CurrencyId id, const char* code, const char* name, int minorUnits, const char* symbol) {
+    size_t codeLength = strlen(code);
+    size_t nameLength = strlen(name);
+    if (id >= catalog->count || codeLength == 0 || codeLength >= CURRENCY_CODE_SIZE ||
+        catalog->nameArenaUsed + nameLength + 1 > catalog->nameArenaSize) {
+        return false;
+    }
+
+    memcpy(catalog->codes[id], code, codeLength + 1);
+
+    catalog->nameOffsets[id] = (uint32_t)catalog->nameArenaUsed;
+    memcpy(catalog->nameArena + catalog->nameArenaUsed, name, nameLength + 1);
+    catalog->nameArenaUsed += nameLength + 1;
+
+    if (symbol == NULL || strlen(symbol) == 0 || strlen(symbol) >= CURRENCY_SYMBOL_SIZE) {
+        symbol = code;
+    }
+    strncpy(catalog->symbols[id], symbol, CURRENCY_SYMBOL_SIZE - 1);
+
+    catalog->minorUnits[id] = (uint8_t)(minorUnits >= 0 && minorUnits <= 9 ? minorUnits : DEFAULT_MINOR_UNITS);
+
+    indexCatalogCode(catalog, id);
+    return true;
+}
+
+
+// Function to find the ID of a currency code
+// Three-letter uppercase codes resolve with a single table load; other codes
+// (e.g. longer crypto tickers) fall back to a scan of the catalog
+CurrencyId findCurrencyId(const CurrencyCatalog* catalog, const char* code) {
+    if (catalog == NULL) {
+        return INVALID_CURRENCY_ID;
+    }
+
+    int packed = packCurrencyCode(code);
+    if (packed >= 0) {
+        uint16_t entry = catalog->codeIndex[packed];
+        return entry != 0 && entry <= catalog->count ? (CurrencyId)(entry - 1) : INVALID_CURRENCY_ID;
+    }
+
+    for (int i = 0; i < catalog->count; ++i) {
+        if (strcmp(code, catalog->codes[i]) == 0) {
+            return (CurrencyId)i;
+        }
+    }
+    return INVALID_CURRENCY_ID;
+}
+
+
+// Function to get the code of a currency
+const char* getCurrencyCode(const CurrencyCatalog* catalog, CurrencyId id) {
+    return catalog->codes[id];
+}
+
+
+// Function to get the full name of a currency
+const char* getCurrencyName(const CurrencyCatalog* catalog, CurrencyId id) {
+    return catalog->nameArena + catalog->nameOffsets[id];
+}
+
+
+// Function to get the display symbol of a currency
+const char* getCurrencySymbol(const CurrencyCatalog* catalog, CurrencyId id) {
+    return catalog->symbols[id];
+}
+
+
+// Function to get the number of decimal digits of a currency
+int getCurrencyMinorUnits(const CurrencyCatalog* catalog, CurrencyId id) {
+    return catalog->minorUnits[id];
+}
+
+
+// Function to release a catalog
+void freeCurrencyCatalog(CurrencyCatalog* catalog) {
+    free(catalog); // Struct, arrays and name arena share one allocation
+}
+
+
+// Function to get the active catalog
+const CurrencyCatalog* getActiveCatalog() {
+    return activeCatalog;
+}
+
+
+// Function to install a new catalog generation
+// The pointer is exchanged atomically, so a reader sees either the old or the new catalog, never a mix.
+// The old generation is freed right away, which is safe because swaps happen on the menu thread,
+// the only thread that reads the active catalog; background refreshes hand their result over instead.
+// Each installed catalog gets a new generation number so data keyed by its IDs can detect the change.
+void swapActiveCatalog(CurrencyCatalog* catalog) {
+    if (catalog != NULL) {
+        catalog->generation = ++catalogGeneration;
+    }
+    CurrencyCatalog* previous = InterlockedExchangePointer((void* volatile*)&activeCatalog, catalog);
+    if (previous != catalog) {
+        freeCurrencyCatalog(previous);
+    }
+}
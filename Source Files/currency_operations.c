@@ -3,6 +3,9 @@
 #include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
 #include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
 #include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <ctype.h>      // Library for character classification functions like tolower
+#include <limits.h>     // Library defining the limits of integer types like INT_MAX
+#include <time.h>       // Library for date and time functions like time, localtime, etc.
 #include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
 #include <windows.h>    // Library providing functions for Windows API and system-related functions
 #include <curl/curl.h>  // Library for making HTTP requests and working with URLs using libcurl
@@ -12,6 +15,14 @@
 #include "date_utils.h" // Header file containing utility functions for handling dates and times
 #include "api_utils.h"  // Header file containing API-related constants, structures, and functions
 #include "utilities.h" // Header file for miscellaneous utility functions
+#include "currency_catalog.h" // Header file for the currency catalog object
+#include "http_client.h" // Header file for the shared HTTP transport layer
+#include "rate_engine.h" // Header file for the local cross-rate engine
+
+
+// Counters of how catalog downloads ended, updated from the background refresh thread
+static volatile LONG fullCatalogDownloads = 0; // Responses that carried a full catalog body
+static volatile LONG notModifiedResponses = 0; // 304 responses that avoided a download
 
 
 // Function to perform currency conversion
@@ -22,93 +33,316 @@ double convertCurrency(double amount, double exchangeRate) {
 }
 
 
-// Function to initialize and fetch supported currencies
-// Fetches currency data from an API, parses the JSON response, and stores supported currency codes globally
-void fetchSupportedCurrencies() {
-    CURL *curl; // CURL session handle
-    CURLcode res; // CURL operation result
-    struct MemoryStruct chunk; // Structure to hold received data
-    char errorBuffer[CURL_ERROR_SIZE]; // Buffer to store error messages
+// Fields of a /currencies entry that end up in the catalog
+typedef enum CatalogField {
+    FIELD_NONE,
+    FIELD_CODE,
+    FIELD_NAME,
+    FIELD_SYMBOL,
+    FIELD_DIGITS
+} CatalogField;
+
+#define NO_TEXT ((size_t)-1) // Offset of a field the entry did not provide as a string
+#define CATALOG_TEXT_INITIAL_SIZE 4096 // Initial capacity of a builder's text, doubled as needed
+
+
+// Entry of the /currencies response as read by the event parser, before it goes into the catalog
+typedef struct CatalogDraft {
+    size_t code;            // Offset of the code in the builder's text (NO_TEXT if absent)
+    size_t name;            // Offset of the name in the builder's text (NO_TEXT if absent)
+    size_t symbol;          // Offset of the symbol in the builder's text (NO_TEXT if absent)
+    int minorUnits;         // Value of "decimal_digits" (DEFAULT_MINOR_UNITS if absent)
+    unsigned seenFields;    // Bit per CatalogField whose key has been met; later duplicates are ignored
+} CatalogDraft;
+
+
+// State of the event handler collecting the entries of a /currencies response
+// The strings are copied into 'text', which grows as the response arrives
+typedef struct CatalogBuilder {
+    char* text;                 // Codes, names and symbols of the entries, null-terminated, back to back
+    size_t textUsed;            // Bytes of 'text' filled so far
+    size_t textSize;            // Capacity of 'text' in bytes
+    CatalogDraft* drafts;       // Entries that have a code
+    int count;                  // Number of entries in 'drafts'
+    int capacity;               // Capacity of 'drafts'
+    size_t nameBytes;           // Bytes the names will take in the catalog, terminators included
+    int depth;                  // Nesting depth of the current value (1 = the top-level container)
+    bool inEntry;               // Whether the container at depth 2 is an entry object
+    CatalogField pending;       // Field the next value at depth 2 belongs to
+    CatalogDraft current;       // Entry being read
+} CatalogBuilder;
+
+
+// Function to compare a key with a field name, ignoring case like cJSON_GetObjectItem
+static bool keyMatches(const char* key, const char* field) {
+    while (*key != '\0' && tolower((unsigned char)*key) == *field) {
+        key++;
+        field++;
+    }
+    return *key == '\0' && *field == '\0';
+}
 
-    // Initialize memory chunk
-    chunk.memory = malloc(1);
-    chunk.size = 0;
 
-    curl = curl_easy_init(); // Initialize CURL session
-    if (curl) {
-        // Set the API URL and key
-        char url[200];
-        sprintf(url, "%s?api_key=%s", URL_CURRENCY, API_KEY);
+// Function to copy a string of the response into the builder's text, returning its offset
+static size_t keepCatalogText(CatalogBuilder* builder, const char* value) {
+    size_t length = strlen(value) + 1;
+    if (builder->textUsed + length > builder->textSize) {
+        size_t size = builder->textSize * 2;
+        while (builder->textUsed + length > size) {
+            size *= 2;
+        }
+        char* text = realloc(builder->text, size);
+        if (text == NULL) {
+            return NO_TEXT;
+        }
+        builder->text = text;
+        builder->textSize = size;
+    }
+    memcpy(builder->text + builder->textUsed, value, length);
+    builder->textUsed += length;
+    return builder->textUsed - length;
+}
 
-        // Set CURL options
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallbackForCurrency);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
-        curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errorBuffer);
 
-        // Perform the API request
-        res = curl_easy_perform(curl);
+// Event handlers for the /currencies response: every object directly inside the top-level container is an entry
+// Function to enter an object or array, starting a new entry when it is one level inside the top-level container
+static cJSON_bool catalogStartContainer(void* context, bool isObject) {
+    CatalogBuilder* builder = (CatalogBuilder*)context;
+    builder->pending = FIELD_NONE; // A container is never one of the wanted values
+    builder->depth++;
+    if (builder->depth == 2) {
+        builder->inEntry = isObject;
+        builder->current.code = builder->current.name = builder->current.symbol = NO_TEXT;
+        builder->current.minorUnits = DEFAULT_MINOR_UNITS;
+        builder->current.seenFields = 0;
+    }
+    return true;
+}
 
-        if (res != CURLE_OK) {
-            // Display error message if request fails
-            fprintf(stderr, "\n\t\t\t\t\t\t\tcurl_easy_perform() failed: %s\n", curl_easy_strerror(res));
-            if (errorBuffer[0] != '\0') {
-                fprintf(stderr, "\n\t\t\t\t\t\t\tError: %s\n", errorBuffer);
+// Function to handle the start of an object
+static cJSON_bool catalogStartObject(void* context) {
+    return catalogStartContainer(context, true);
+}
+
+// Function to handle the start of an array
+static cJSON_bool catalogStartArray(void* context) {
+    return catalogStartContainer(context, false);
+}
+
+// Function to leave an object or array, keeping the entry it closes if that entry has a code
+static cJSON_bool catalogEndContainer(void* context) {
+    CatalogBuilder* builder = (CatalogBuilder*)context;
+    if (builder->depth == 2 && builder->inEntry && builder->current.code != NO_TEXT) {
+        if (builder->count == builder->capacity) {
+            int capacity = builder->capacity * 2;
+            CatalogDraft* drafts = realloc(builder->drafts, capacity * sizeof(CatalogDraft));
+            if (drafts == NULL) {
+                return false; // Stop the parse: the catalog would be incomplete
             }
-        } else {
-            // Parse JSON response and store currency codes globally
-            cJSON *json = cJSON_Parse(chunk.memory);
-            if (json != NULL) {
-                cJSON *currency = NULL;
-                cJSON_ArrayForEach(currency, json) {
-                    cJSON *code = cJSON_GetObjectItem(currency, "code");
-                    if (code != NULL) {
-                        // Increment the number of currencies and allocate memory for the new code
-                        supportedCurrencies = realloc(supportedCurrencies, (numberOfCurrencies + 1) * sizeof(char*));
-                        supportedCurrencies[numberOfCurrencies] = strdup(code->valuestring);
-                        numberOfCurrencies++;
-                    }
-                }
-                cJSON_Delete(json); // Clean up cJSON object
-            } else {
-                fprintf(stderr, "\n\t\t\t\t\t\t\tError parsing JSON\n");
+            builder->drafts = drafts;
+            builder->capacity = capacity;
+        }
+        const char* name = builder->current.name != NO_TEXT ? builder->text + builder->current.name : "";
+        builder->nameBytes += strlen(name) + 1;
+        builder->drafts[builder->count++] = builder->current;
+    }
+    builder->inEntry = builder->inEntry && builder->depth != 2;
+    builder->depth--;
+    return true;
+}
+
+// Function to note which wanted field, if any, the next value of an entry belongs to
+static cJSON_bool catalogKey(void* context, const char* key) {
+    CatalogBuilder* builder = (CatalogBuilder*)context;
+    CatalogField field = FIELD_NONE;
+    builder->pending = FIELD_NONE;
+    if (builder->depth != 2 || !builder->inEntry) {
+        return true;
+    }
+
+    if (keyMatches(key, "code")) {
+        field = FIELD_CODE;
+    } else if (keyMatches(key, "name")) {
+        field = FIELD_NAME;
+    } else if (keyMatches(key, "symbol")) {
+        field = FIELD_SYMBOL;
+    } else if (keyMatches(key, "decimal_digits")) {
+        field = FIELD_DIGITS;
+    }
+
+    // Only the first occurrence of a key counts, whatever its value
+    if (field != FIELD_NONE && !(builder->current.seenFields & (1u << field))) {
+        builder->current.seenFields |= 1u << field;
+        builder->pending = field;
+    }
+    return true;
+}
+
+// Function to keep a string value of a wanted field
+static cJSON_bool catalogString(void* context, const char* value) {
+    CatalogBuilder* builder = (CatalogBuilder*)context;
+    switch (builder->pending) {
+        case FIELD_CODE:
+            builder->current.code = keepCatalogText(builder, value);
+            break;
+        case FIELD_NAME:
+            builder->current.name = keepCatalogText(builder, value);
+            break;
+        case FIELD_SYMBOL:
+            builder->current.symbol = keepCatalogText(builder, value);
+            break;
+        default:
+            break;
+    }
+    builder->pending = FIELD_NONE;
+    return true;
+}
+
+// Function to keep the number of decimal digits of an entry
+static cJSON_bool catalogNumber(void* context, double value) {
+    CatalogBuilder* builder = (CatalogBuilder*)context;
+    if (builder->pending == FIELD_DIGITS) {
+        // Saturate like cJSON's valueint
+        builder->current.minorUnits = value >= INT_MAX ? INT_MAX : (value <= (double)INT_MIN ? INT_MIN : (int)value);
+    }
+    builder->pending = FIELD_NONE;
+    return true;
+}
+
+// Function to skip a boolean value, which is never one of the wanted fields
+static cJSON_bool catalogBoolean(void* context, cJSON_bool value) {
+    (void)value;
+    ((CatalogBuilder*)context)->pending = FIELD_NONE;
+    return true;
+}
+
+// Function to skip a null value, which is never one of the wanted fields
+static cJSON_bool catalogNull(void* context) {
+    ((CatalogBuilder*)context)->pending = FIELD_NONE;
+    return true;
+}
+
+
+static const cJSON_SAXHandler catalogHandler = {
+    catalogStartObject, catalogEndContainer, catalogStartArray, catalogEndContainer,
+    catalogKey, catalogString, catalogNumber, catalogBoolean, catalogNull
+};
+
+
+// Function to prepare an empty catalog builder
+// Returns false if its buffers cannot be allocated
+static bool initCatalogBuilder(CatalogBuilder* builder) {
+    memset(builder, 0, sizeof(CatalogBuilder));
+    builder->textSize = CATALOG_TEXT_INITIAL_SIZE;
+    builder->text = malloc(builder->textSize);
+    builder->capacity = 256;
+    builder->drafts = malloc(builder->capacity * sizeof(CatalogDraft));
+    if (builder->text == NULL || builder->drafts == NULL) {
+        free(builder->text);
+        free(builder->drafts);
+        return false;
+    }
+    return true;
+}
+
+
+// Function to free the buffers of a catalog builder
+static void freeCatalogBuilder(CatalogBuilder* builder) {
+    free(builder->text);
+    free(builder->drafts);
+}
+
+
+// Function to build a catalog from the entries collected from a /currencies response
+// The catalog and its name arena are allocated once at their final size; entries beyond MAX_CURRENCIES are skipped
+static CurrencyCatalog* buildCurrencyCatalog(const CatalogBuilder* builder) {
+    CurrencyCatalog* catalog = NULL;
+    int slots = builder->count < MAX_CURRENCIES ? builder->count : MAX_CURRENCIES;
+
+    if (slots > 0) {
+        catalog = createCurrencyCatalog(slots, builder->nameBytes);
+    }
+
+    if (catalog != NULL) {
+        int index = 0;
+        for (int i = 0; i < builder->count && index < slots; i++) {
+            const CatalogDraft* draft = &builder->drafts[i];
+            const char* name = draft->name != NO_TEXT ? builder->text + draft->name : "";
+            const char* symbol = draft->symbol != NO_TEXT ? builder->text + draft->symbol : NULL;
+            if (setCatalogEntry(catalog, (CurrencyId)index, builder->text + draft->code, name, draft->minorUnits, symbol)) {
+                index++;
             }
         }
+        catalog->count = index; // Entries that did not fit their slots are skipped
+        catalog->fetchedAt = time(NULL);
 
-        free(chunk.memory); // Free allocated memory
-        curl_easy_cleanup(curl); // Cleanup CURL session
+        if (index == 0) {
+            freeCurrencyCatalog(catalog);
+            catalog = NULL;
+        }
     }
+    return catalog;
 }
 
 
-// Function to fetch and display supported currencies
-// Uses an API request to retrieve currency data and parses JSON response to display codes and names
-void displaySupportedCurrencies() {
-    CURL *curl;
-    CURLcode res;
-    struct MemoryStruct chunk; // Structure to hold received data
+// Function to download the supported currencies into a new catalog
+// Fetches currency data from an API and parses the JSON response off to the side of the active catalog.
+// The response is parsed by the event parser while it downloads, so the body is never held in memory.
+// When 'previous' holds validators of an earlier response, the request is conditional: a
+// 304 Not Modified answer skips the body transfer and the parse and sets '*notModified'.
+// Returns NULL on failure or when not modified; the caller owns the returned catalog
+CurrencyCatalog* downloadCurrencyCatalog(const CatalogValidators* previous, bool* notModified) {
+    CURL *curl; // CURL session handle
+    CURLcode res; // CURL operation result
+    HttpResponse response; // Status and timings of the request
+    CatalogBuilder builder; // Entries collected from the response as it arrives
+    cJSON_StreamParser *parser; // Parser fed with the response body
     char errorBuffer[CURL_ERROR_SIZE]; // Buffer to store error messages
+    CatalogValidators validators; // Validators sent with this response
+    CurrencyCatalog *catalog = NULL; // Catalog built from the response
+
+    memset(&validators, 0, sizeof(validators));
+
+    if (notModified != NULL) {
+        *notModified = false;
+    }
 
-    // Initialize memory chunk
-    chunk.memory = malloc(1);
-    chunk.size = 0;
+    if (!initCatalogBuilder(&builder)) {
+        return NULL;
+    }
+    parser = cJSON_CreateStreamParser(&catalogHandler, &builder);
 
-    curl = curl_easy_init(); // Initialize CURL session
+    curl = parser != NULL ? acquireHttpHandle() : NULL; // Borrow a warm CURL handle from the pool
     if (curl) {
         // Set the API URL and key
-        char url[200];
-        sprintf(url, "%s?api_key=%s", URL_CURRENCY, API_KEY);
+        char url[512];
+        snprintf(url, sizeof(url), URL_CURRENCY "?api_key=%s", getApiBaseUrl(), API_KEY);
+
+        // Add conditional headers from the previous response, if any
+        struct curl_slist* headers = NULL;
+        if (previous != NULL) {
+            char header[CATALOG_VALIDATOR_SIZE + 32];
+            if (previous->etag[0] != '\0') {
+                snprintf(header, sizeof(header), "If-None-Match: %s", previous->etag);
+                headers = curl_slist_append(headers, header);
+            }
+            if (previous->lastModified[0] != '\0') {
+                snprintf(header, sizeof(header), "If-Modified-Since: %s", previous->lastModified);
+                headers = curl_slist_append(headers, header);
+            }
+        }
 
         // Set CURL options
         curl_easy_setopt(curl, CURLOPT_URL, url);
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallbackForCurrency);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallbackForStream);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)parser);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, headerCallbackForValidators);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)&validators);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
         curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, errorBuffer);
 
         // Perform the API request
-        res = curl_easy_perform(curl);
+        res = performHttpRequest(curl, &response);
 
         if (res != CURLE_OK) {
             // Display error message if request fails
@@ -116,45 +350,98 @@ void displaySupportedCurrencies() {
             if (errorBuffer[0] != '\0') {
                 fprintf(stderr, "\n\t\t\t\t\t\t\tError: %s\n", errorBuffer);
             }
+        } else if (response.status == 304) {
+            // The cached catalog is still current; nothing was transferred or parsed
+            InterlockedIncrement(&notModifiedResponses);
+            if (notModified != NULL) {
+                *notModified = true;
+            }
+        } else if (response.status != 200) {
+            // An error body is not a catalog and does not count as a download
+            fprintf(stderr, "\n\t\t\t\t\t\t\tError: The currency list request failed with HTTP status %ld\n", response.status);
         } else {
-            // Parse JSON response and display currency codes and names
-            cJSON *json = cJSON_Parse(chunk.memory);
-            if (json != NULL) {
-                cJSON *currency = NULL;
-                cJSON_ArrayForEach(currency, json) {
-                    cJSON *code = cJSON_GetObjectItem(currency, "code");
-                    cJSON *name = cJSON_GetObjectItem(currency, "name");
-                    if (code != NULL && name != NULL) {
-                        SetConsoleOutputCP(CP_UTF8); // Set console to UTF-8 for proper character display
-                        printf("\n\n\t\t\t\t\t\t\t%s - %s\n", code->valuestring, name->valuestring);
-                    }
-                }
-                cJSON_Delete(json); // Clean up cJSON object
-            } else {
+            // The body has been parsed as it arrived; build the catalog from the currency codes
+            InterlockedIncrement(&fullCatalogDownloads);
+            if (!cJSON_FinishStreamParser(parser)) {
                 fprintf(stderr, "\n\t\t\t\t\t\t\tError parsing JSON\n");
+            } else {
+                catalog = buildCurrencyCatalog(&builder);
+            }
+            if (catalog != NULL) {
+                catalog->validators = validators;
             }
         }
 
-        free(chunk.memory); // Free allocated memory
-        curl_easy_cleanup(curl); // Cleanup CURL session
+        curl_slist_free_all(headers);
+        releaseHttpHandle(curl); // Return the handle to the pool, keeping its connection open
+    }
+
+    cJSON_DeleteStreamParser(parser);
+    freeCatalogBuilder(&builder); // Free the collected entries
+    return catalog;
+}
+
+
+// Function to read how catalog downloads ended during this session
+// 'fullDownloads' counts 200 responses with a body, 'notModified' counts 304 answers that avoided one
+void getCatalogRevalidationStats(long* fullDownloads, long* notModified) {
+    *fullDownloads = fullCatalogDownloads;
+    *notModified = notModifiedResponses;
+}
+
+
+// Function to fetch supported currencies and make them the active catalog
+// Replaces the active catalog as a whole instead of appending to it
+void fetchSupportedCurrencies() {
+    CurrencyCatalog* catalog = downloadCurrencyCatalog(NULL, NULL);
+    if (catalog != NULL) {
+        swapActiveCatalog(catalog);
     }
 }
 
 
+// Function to display supported currencies
+// Lists the codes and names of the active catalog; no API request is made
+void displaySupportedCurrencies() {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    if (catalog == NULL) {
+        fprintf(stderr, "\n\t\t\t\t\t\t\tError: Supported currencies are not available yet.\n");
+        return;
+    }
+
+    SetConsoleOutputCP(CP_UTF8); // Set console to UTF-8 for proper character display
+    for (CurrencyId id = 0; id < catalog->count; ++id) {
+        printf("\n\n\t\t\t\t\t\t\t%s - %s\n", getCurrencyCode(catalog, id), getCurrencyName(catalog, id));
+    }
+
+    // Report how often the catalog was revalidated without a download
+    long fullDownloads, notModified;
+    getCatalogRevalidationStats(&fullDownloads, &notModified);
+    printf("\n\t\t\t\t\t\t\tCatalog checks this session: %ld full download(s), %ld not modified\n", fullDownloads, notModified);
+}
+
+
 // Perform currency conversion using FX Rates API with cJSON for JSON parsing
-void performCurrencyConversion(double amount, const char* fromCurrency, const char* toCurrency, const char* date) {
-    // Validate 'fromCurrency'
-    if (!isValidCurrency(fromCurrency)) {
+// The currencies are given as IDs of the active catalog
+void performCurrencyConversion(double amount, CurrencyId fromId, CurrencyId toId, const char* date) {
+    // Validate 'fromId'
+    if (!isValidCurrencyId(fromId)) {
         fprintf(stderr, "\n\t\t\t\t\t\t\tError: Invalid 'from' currency code.\n\n");
         return;
     }
 
-    // Validate 'toCurrency'
-    if (!isValidCurrency(toCurrency)) {
+    // Validate 'toId'
+    if (!isValidCurrencyId(toId)) {
         fprintf(stderr, "\n\t\t\t\t\t\t\tError: Invalid 'to' currency code.\n\n");
         return;
     }
 
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    const char* fromCurrency = getCurrencyCode(catalog, fromId);
+    const char* toCurrency = getCurrencyCode(catalog, toId);
+    int fromDigits = getCurrencyMinorUnits(catalog, fromId); // Decimal digits used to print the source amount
+    int toDigits = getCurrencyMinorUnits(catalog, toId); // Decimal digits used to print the converted amount
+
     // Validate 'date' format
     if (!validateDateFormat(date)) {
         fprintf(stderr, "\n\t\t\t\t\t\t\tError: Invalid date format. Please use YYYY-MM-DD format.\n\n");
@@ -171,114 +458,32 @@ void performCurrencyConversion(double amount, const char* fromCurrency, const ch
     }
         
 	
-    char url[200];
-    sprintf(url, URL_CONVERT, fromCurrency, toCurrency, date, amount);
-
-    // Initialize CURL session
-    CURL* curl = curl_easy_init();
-    if (curl) {
-        char response[RESPONSE_BUFFER_SIZE] = {0};
-        CURLcode res;
-
-        // Set the URL
-        curl_easy_setopt(curl, CURLOPT_URL, url);
-
-        // Disable SSL verification
-        curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-
-        // Set the write callback function
-        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallbackForConversion);
-        curl_easy_setopt(curl, CURLOPT_WRITEDATA, response);
-
-        // Set authentication header
-        struct curl_slist* headers = NULL;
-        char authHeader[100];
-        sprintf(authHeader, "\n\t\t\t\t\t\t\tAuthorization: Bearer %s", API_KEY);
-        headers = curl_slist_append(headers, authHeader);
-        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+    // Derive the rate locally from the cached base-currency vector of that date
+    double exchangeRate;
+    if (!getCrossRate(fromId, toId, date, &exchangeRate)) {
+        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------\n");
+        fprintf(stderr, "\n\t\t\t\t\t\t\tNo exchange rate available for %s to %s on %s.\n", fromCurrency, toCurrency, date);
+        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
 
-        // Make the API request
-        res = curl_easy_perform(curl);
+        clearInputBuffer(); // Clear the input buffer
+        return;
+    }
 
-        if (res != CURLE_OK) {
-            // Handle request failure
-            fprintf(stderr, "\n\t\t\t\t\t\t\tFailed to fetch exchange rates: %s\n\n", curl_easy_strerror(res));
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
-            return;
-        }
+    double convertedAmount = convertCurrency(amount, exchangeRate);
 
-        // Parse the API response using cJSON
-        cJSON* jsonResponse = cJSON_Parse(response);
-        if (jsonResponse) {
-            // Check for API response success
-            cJSON* success = cJSON_GetObjectItemCaseSensitive(jsonResponse, "success");
-            if (cJSON_IsFalse(success)) {
-                // Handle API error response
-                cJSON* error = cJSON_GetObjectItemCaseSensitive(jsonResponse, "error");
-                cJSON* description = cJSON_GetObjectItemCaseSensitive(jsonResponse, "description");
-                if (cJSON_IsString(error) && cJSON_IsString(description)) {
-                    fprintf(stderr, "\n\t\t\t\t\t\t\tFailed to fetch exchange rates.\n\n");
-                    // Print error details
-                    fprintf(stderr, "\n\t\t\t\t\t\t\tError Result:");
-                    fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
-                    fprintf(stderr, "\n\t\t\t\t\t\t\tError: %s\n", error->valuestring);
-                    fprintf(stderr, "\n\t\t\t\t\t\t\tDescription: %s", description->valuestring);
-                    fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
-
-                    cJSON_Delete(jsonResponse); // Clean up cJSON object
-                    curl_slist_free_all(headers);
-                    curl_easy_cleanup(curl);
-                    
-                    clearInputBuffer(); // Clear the input buffer
-                    
-                    return;
-                }
-            }
+    // Print the conversion result
+    printf("\n\t\t\t\t\t\t\tConversion Result:");
+    printf("\n\t\t\t\t\t\t\t-----------------------------------------------------------------");
+    printf("\n\t\t\t\t\t\t\t%.*lf %s is equal to %.*lf %s on %s\n", fromDigits, amount, fromCurrency, toDigits, convertedAmount, toCurrency, date);
+    printf("\n\t\t\t\t\t\t\tConverted: %.*lf %s = %.*lf %s", fromDigits, amount, fromCurrency, toDigits, convertedAmount, toCurrency);
+    printf("\n\t\t\t\t\t\t\tExchange Rate: 1 %s = %.2lf %s", fromCurrency, exchangeRate, toCurrency);
+    printf("\n\t\t\t\t\t\t\tDate: %s\n", date);
 
-            // Process the successful API response
-            cJSON* info = cJSON_GetObjectItemCaseSensitive(jsonResponse, "info");
-            if (cJSON_IsObject(info)) {
-                cJSON* rate = cJSON_GetObjectItemCaseSensitive(info, "rate");
-                if (cJSON_IsNumber(rate)) {
-                    // Extract and calculate conversion details
-                    double exchangeRate = rate->valuedouble;
-                    double convertedAmount = convertCurrency(amount, exchangeRate);
-
-                    // Print the conversion result
-                    printf("\n\t\t\t\t\t\t\tConversion Result:");
-                    printf("\n\t\t\t\t\t\t\t-----------------------------------------------------------------");
-                    printf("\n\t\t\t\t\t\t\t%.2lf %s is equal to %.2lf %s on %s\n", amount, fromCurrency, convertedAmount, toCurrency, date);
-                    printf("\n\t\t\t\t\t\t\tConverted: %.2lf %s = %.2lf %s", amount, fromCurrency, convertedAmount, toCurrency);
-                    printf("\n\t\t\t\t\t\t\tExchange Rate: 1 %s = %.2lf %s", fromCurrency, exchangeRate, toCurrency);
-                    printf("\n\t\t\t\t\t\t\tDate: %s\n", date);
-
-                    // Display last updated time
-                    displayLastUpdatedTime();
-
-                    printf("\t\t\t\t\t\t\t-----------------------------------------------------------------");
-                    
-                    clearInputBuffer();
-
-                    cJSON_Delete(jsonResponse); // Clean up cJSON object
-                    curl_slist_free_all(headers);
-                    curl_easy_cleanup(curl);
-                    return;
-                }
-            }
+    // Display last updated time
+    displayLastUpdatedTime();
 
-            cJSON_Delete(jsonResponse); // Clean up cJSON object if parsing fails
-        }
-
-        // Handle failure to parse exchange rate data from API response
-        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------\n");
-        fprintf(stderr, "\n\t\t\t\t\t\t\tFailed to parse exchange rate data from API response.\n");
-        fprintf(stderr, "\n\t\t\t\t\t\t\tAPI Response: %s\n", response);
-        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
+    printf("\t\t\t\t\t\t\t-----------------------------------------------------------------");
 
-        curl_slist_free_all(headers);
-        curl_easy_cleanup(curl);
-        return;
-    }
+    clearInputBuffer(); // Clear the input buffer
 }
 
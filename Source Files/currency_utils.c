@@ -6,29 +6,42 @@
 #include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
 #include "api_utils.h"  // Header file containing API-related constants, structures, and functions
 #include "currency_utils.h" // Header file providing utility functions for currency handling
+#include "currency_catalog.h" // Header file for the currency catalog object
+
+
+// Function to get the ID of a currency code
+// Resolves the code through the packed index of the active catalog
+CurrencyId getCurrencyId(const char* currencyCode) {
+    return findCurrencyId(getActiveCatalog(), currencyCode);
+}
 
 
 // Function to validate a currency code
 // Checks if the provided currency code exists in the list of supported currencies
 bool isValidCurrency(const char* currencyCode) {
-    // Loop through the supportedCurrencies array to check if the inputted currency code is valid
-    for (int i = 0; i < numberOfCurrencies; ++i) {
-        if (strcmp(currencyCode, supportedCurrencies[i]) == 0) {
-            return true; // Valid currency code found
-        }
-    }
-    return false; // Currency code not found in the supported list
+    return getCurrencyId(currencyCode) != INVALID_CURRENCY_ID;
+}
+
+
+// Function to validate a currency ID
+// Checks if the ID falls within the active catalog
+bool isValidCurrencyId(CurrencyId id) {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    return catalog != NULL && id < catalog->count;
 }
 
 
 // Function to validate user input for a currency code
 // Prompts the user to input a currency code for a specified type (source or target)
 // Loops until a valid non-empty currency code is entered, displaying error messages as needed
-void validateCurrency(char* currency, const char* type) {
+// Returns the catalog ID of the entered currency
+CurrencyId validateCurrency(const char* type) {
+    char currency[50]; // Buffer to store the entered currency code
+
     while (1) {
         printf("\n\t\t\t\t\t\t\tPlease select your %s currency (e.g., GBP, USD, EUR): \n", type);
         printf("\t\t\t\t\t\t\t> ");
-        fgets(currency, 50, stdin); // Read input
+        fgets(currency, sizeof(currency), stdin); // Read input
 
         // Remove newline character if present
         size_t length = strlen(currency);
@@ -43,10 +56,11 @@ void validateCurrency(char* currency, const char* type) {
         }
 
         // Validate currency code
-        if (!isValidCurrency(currency)) {
+        CurrencyId id = getCurrencyId(currency);
+        if (id == INVALID_CURRENCY_ID) {
             fprintf(stderr, "\n\t\t\t\t\t\t\tError: Invalid %s currency code.\n", type);
         } else {
-            break; // Valid currency code entered, exit the loop
+            return id; // Valid currency code entered, exit the loop
         }
     }
 }
@@ -115,6 +115,40 @@ void getCurrentDateUTC(char* currentDate) {
 }
 
 
+// Function to convert a date to a day number
+// Counts the days from 1970-01-01 to 'date' in the proleptic Gregorian calendar (negative for earlier dates)
+// The caller is expected to have checked the format with validateDateFormat()
+long getDayNumber(const char* date) {
+    int year, month, day;
+    sscanf(date, "%4d-%2d-%2d", &year, &month, &day);
+
+    // Count years from March so the leap day falls at the end of the year
+    year -= month <= 2;
+    long era = (year >= 0 ? year : year - 399) / 400;
+    long yearOfEra = year - era * 400;
+    long dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    long dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    return era * 146097 + dayOfEra - 719468;
+}
+
+
+// Function to convert a day number back to a date
+// Inverse of getDayNumber(); 'date' must have room for 11 characters
+void formatDayNumber(long dayNumber, char* date) {
+    dayNumber += 719468;
+    long era = (dayNumber >= 0 ? dayNumber : dayNumber - 146096) / 146097;
+    long dayOfEra = dayNumber - era * 146097;
+    long yearOfEra = (dayOfEra - dayOfEra / 1460 + dayOfEra / 36524 - dayOfEra / 146096) / 365;
+    long dayOfYear = dayOfEra - (365 * yearOfEra + yearOfEra / 4 - yearOfEra / 100);
+    long monthIndex = (5 * dayOfYear + 2) / 153; // Months counted from March
+    int day = (int)(dayOfYear - (153 * monthIndex + 2) / 5 + 1);
+    int month = (int)(monthIndex < 10 ? monthIndex + 3 : monthIndex - 9);
+    long year = yearOfEra + era * 400 + (month <= 2);
+
+    snprintf(date, 11, "%04ld-%02d-%02d", year, month, day);
+}
+
+
 // Function to convert the input string to lowercase
 // Parameters:
 // - str: Pointer to the string to be converted to lowercase
@@ -0,0 +1,143 @@
+// http_async.c - Source file for the asynchronous request engine
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <curl/curl.h>  // Library for making HTTP requests and working with URLs using libcurl
+#include "http_client.h" // Header file for the shared HTTP transport layer
+#include "http_async.h" // Header file for the asynchronous request engine
+
+
+// Completion details attached to each submitted handle through CURLOPT_PRIVATE
+typedef struct HttpPendingRequest {
+    CURL* handle;                    // Handle running the request
+    HttpCompletionCallback callback; // Function to call when the request finishes
+    void* userData;                  // Argument passed through to the callback
+    struct HttpPendingRequest* next; // Next request in flight on the same queue
+} HttpPendingRequest;
+
+
+// Function to create a request queue
+// Requests to the same host share one connection when the server speaks HTTP/2; otherwise up to
+// HTTP_ASYNC_MAX_HOST_CONNECTIONS HTTP/1.1 connections are opened and the rest of the requests wait for them
+bool initHttpRequestQueue(HttpRequestQueue* queue) {
+    queue->inFlight = 0;
+    queue->pending = NULL;
+    queue->multi = curl_multi_init();
+    if (queue->multi == NULL) {
+        return false;
+    }
+
+    curl_multi_setopt(queue->multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    curl_multi_setopt(queue->multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)HTTP_ASYNC_MAX_HOST_CONNECTIONS);
+    return true;
+}
+
+
+// Function to complete one finished transfer
+// Collects its timings, hands them to the callback and returns the handle to the pool
+static void completeHttpRequest(HttpRequestQueue* queue, CURL* handle, CURLcode result) {
+    HttpPendingRequest* pending = NULL;
+    HttpResponse response;
+
+    curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&pending);
+    curl_multi_remove_handle(queue->multi, handle);
+    queue->inFlight--;
+
+    // Unlink the request from the list of requests in flight
+    for (HttpPendingRequest** link = &queue->pending; *link != NULL; link = &(*link)->next) {
+        if (*link == pending) {
+            *link = pending->next;
+            break;
+        }
+    }
+
+    collectHttpResponse(handle, result, &response);
+    if (pending != NULL) {
+        if (pending->callback != NULL) {
+            pending->callback(handle, result, &response, pending->userData);
+        }
+        free(pending);
+    }
+    releaseHttpHandle(handle);
+}
+
+
+// Function to release a request queue
+// Requests still in flight are aborted and completed with CURLE_ABORTED_BY_CALLBACK
+void cleanupHttpRequestQueue(HttpRequestQueue* queue) {
+    if (queue->multi == NULL) {
+        return;
+    }
+
+    while (queue->pending != NULL) {
+        completeHttpRequest(queue, queue->pending->handle, CURLE_ABORTED_BY_CALLBACK);
+    }
+
+    curl_multi_cleanup(queue->multi);
+    queue->multi = NULL;
+}
+
+
+// Function to start a request without waiting for it
+// The handle must come from acquireHttpHandle() with its URL and callbacks already set
+// Returns false (and releases the handle) if the request cannot be started
+bool submitHttpRequest(HttpRequestQueue* queue, CURL* handle, HttpCompletionCallback callback, void* userData) {
+    HttpPendingRequest* pending = malloc(sizeof(HttpPendingRequest));
+    if (pending == NULL) {
+        releaseHttpHandle(handle);
+        return false;
+    }
+    pending->handle = handle;
+    pending->callback = callback;
+    pending->userData = userData;
+
+    // Prefer HTTP/2 and wait for an existing connection to turn out multiplexable instead of opening another
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+    curl_easy_setopt(handle, CURLOPT_PIPEWAIT, 1L);
+    curl_easy_setopt(handle, CURLOPT_PRIVATE, pending);
+
+    if (curl_multi_add_handle(queue->multi, handle) != CURLM_OK) {
+        free(pending);
+        releaseHttpHandle(handle);
+        return false;
+    }
+    pending->next = queue->pending;
+    queue->pending = pending;
+    queue->inFlight++;
+    return true;
+}
+
+
+// Function to drive the transfers of a queue
+// Waits at most 'timeoutMs' for socket activity, then dispatches every request that has finished
+int pollHttpRequests(HttpRequestQueue* queue, int timeoutMs) {
+    int running = 0;
+    int messages = 0;
+    CURLMsg* message;
+
+    if (queue->inFlight == 0) {
+        return 0;
+    }
+
+    curl_multi_perform(queue->multi, &running);
+    if (running > 0) {
+        curl_multi_poll(queue->multi, NULL, 0, timeoutMs, NULL);
+        curl_multi_perform(queue->multi, &running);
+    }
+
+    while ((message = curl_multi_info_read(queue->multi, &messages)) != NULL) {
+        if (message->msg == CURLMSG_DONE) {
+            completeHttpRequest(queue, message->easy_handle, message->data.result);
+        }
+    }
+    return queue->inFlight;
+}
+
+
+// Function to wait for every submitted request
+void waitForHttpRequests(HttpRequestQueue* queue) {
+    while (pollHttpRequests(queue, HTTP_ASYNC_POLL_TIMEOUT_MS) > 0) {
+        // Callbacks run inside pollHttpRequests()
+    }
+}
@@ -0,0 +1,201 @@
+// http_client.c - Source file for the shared HTTP transport layer
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
+#include <windows.h>    // Library providing functions for Windows API and system-related functions
+#include <curl/curl.h>  // Library for making HTTP requests and working with URLs using libcurl
+#include "http_client.h" // Header file for the shared HTTP transport layer
+
+
+// Shared caches: every pooled handle resolves and resumes TLS sessions through them
+// Connections are not shared: libcurl does not support a shared connection cache across concurrently running threads,
+// and the catalog refresh thread runs alongside the main thread's transfers. Each handle keeps its own connections.
+static CURLSH* share = NULL; // libcurl share object holding the DNS and TLS session caches
+static CRITICAL_SECTION shareLocks[CURL_LOCK_DATA_LAST]; // One lock per kind of shared data
+
+// Pool of long-lived easy handles
+static CRITICAL_SECTION poolLock; // Guards the two arrays below
+static CURL* pooledHandles[HTTP_POOL_SIZE]; // Handles kept alive between requests
+static bool handleInUse[HTTP_POOL_SIZE]; // Whether each pooled handle is currently lent out
+static bool httpClientReady = false; // Set once initHttpClient() has run
+static bool traceTimings = false; // Print per-request timings to stderr (TCONVERT_HTTP_TRACE)
+
+
+// Lock callback required by libcurl to protect shared data across threads
+static void lockSharedData(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr) {
+    (void)handle;
+    (void)access;
+    (void)userptr;
+    EnterCriticalSection(&shareLocks[data]);
+}
+
+
+// Unlock callback paired with lockSharedData()
+static void unlockSharedData(CURL* handle, curl_lock_data data, void* userptr) {
+    (void)handle;
+    (void)userptr;
+    LeaveCriticalSection(&shareLocks[data]);
+}
+
+
+// Function to initialize the transport layer
+// Must run before any other thread uses libcurl, since curl_global_init is not thread-safe
+void initHttpClient() {
+    if (httpClientReady) {
+        return;
+    }
+
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+
+    for (int i = 0; i < CURL_LOCK_DATA_LAST; ++i) {
+        InitializeCriticalSection(&shareLocks[i]);
+    }
+    InitializeCriticalSection(&poolLock);
+
+    // Share DNS lookups and TLS sessions between all handles
+    share = curl_share_init();
+    if (share != NULL) {
+        curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lockSharedData);
+        curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlockSharedData);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+    }
+
+    const char* trace = getenv(HTTP_TRACE_ENV);
+    traceTimings = trace != NULL && *trace != '\0' && strcmp(trace, "0") != 0;
+
+    httpClientReady = true;
+}
+
+
+// Function to release the transport layer
+// Assumes no request is in flight; pooled handles are cleaned up before the share they use
+void cleanupHttpClient() {
+    if (!httpClientReady) {
+        return;
+    }
+
+    EnterCriticalSection(&poolLock);
+    for (int i = 0; i < HTTP_POOL_SIZE; ++i) {
+        if (pooledHandles[i] != NULL) {
+            curl_easy_cleanup(pooledHandles[i]);
+            pooledHandles[i] = NULL;
+        }
+    }
+    LeaveCriticalSection(&poolLock);
+
+    if (share != NULL) {
+        curl_share_cleanup(share);
+        share = NULL;
+    }
+    curl_global_cleanup();
+    httpClientReady = false;
+}
+
+
+// Function to apply the options every request starts from
+// curl_easy_reset keeps live connections and caches, so only the options need restoring
+static void applyDefaultOptions(CURL* handle) {
+    curl_easy_reset(handle);
+    curl_easy_setopt(handle, CURLOPT_SHARE, share);
+    curl_easy_setopt(handle, CURLOPT_SSL_VERIFYPEER, 0L);
+    curl_easy_setopt(handle, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(handle, CURLOPT_NOSIGNAL, 1L); // Required for use from worker threads
+}
+
+
+// Function to borrow an easy handle
+// Returns a free pooled handle (created on first use); if all are busy, a temporary handle is created
+// Returns NULL only if libcurl cannot allocate a handle
+CURL* acquireHttpHandle() {
+    CURL* handle = NULL;
+
+    if (!httpClientReady) {
+        initHttpClient();
+    }
+
+    EnterCriticalSection(&poolLock);
+    for (int i = 0; i < HTTP_POOL_SIZE; ++i) {
+        if (!handleInUse[i]) {
+            if (pooledHandles[i] == NULL) {
+                pooledHandles[i] = curl_easy_init();
+            }
+            if (pooledHandles[i] != NULL) {
+                handleInUse[i] = true;
+                handle = pooledHandles[i];
+            }
+            break;
+        }
+    }
+    LeaveCriticalSection(&poolLock);
+
+    if (handle == NULL) {
+        handle = curl_easy_init(); // Pool exhausted: fall back to a one-off handle
+    }
+    if (handle != NULL) {
+        applyDefaultOptions(handle);
+    }
+    return handle;
+}
+
+
+// Function to give a handle back to the pool
+// One-off handles created when the pool was exhausted are cleaned up instead
+void releaseHttpHandle(CURL* handle) {
+    if (handle == NULL) {
+        return;
+    }
+
+    EnterCriticalSection(&poolLock);
+    for (int i = 0; i < HTTP_POOL_SIZE; ++i) {
+        if (pooledHandles[i] == handle) {
+            handleInUse[i] = false;
+            LeaveCriticalSection(&poolLock);
+            return;
+        }
+    }
+    LeaveCriticalSection(&poolLock);
+
+    curl_easy_cleanup(handle);
+}
+
+
+// Function to perform a request and collect its timings
+// Returns the libcurl result; 'response' is filled even when the transfer fails
+CURLcode performHttpRequest(CURL* handle, HttpResponse* response) {
+    CURLcode result = curl_easy_perform(handle);
+    collectHttpResponse(handle, result, response);
+    return result;
+}
+
+
+// Function to read the status and timings of a finished transfer, printing them when tracing is on
+void collectHttpResponse(CURL* handle, CURLcode result, HttpResponse* response) {
+    long connects = 0;
+
+    memset(response, 0, sizeof(*response));
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &response->status);
+    curl_easy_getinfo(handle, CURLINFO_NAMELOOKUP_TIME, &response->nameLookupTime);
+    curl_easy_getinfo(handle, CURLINFO_CONNECT_TIME, &response->connectTime);
+    curl_easy_getinfo(handle, CURLINFO_APPCONNECT_TIME, &response->tlsTime);
+    curl_easy_getinfo(handle, CURLINFO_STARTTRANSFER_TIME, &response->firstByteTime);
+    curl_easy_getinfo(handle, CURLINFO_TOTAL_TIME, &response->totalTime);
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects);
+    response->reusedConnection = result == CURLE_OK && connects == 0;
+
+    if (traceTimings) {
+        char* url = NULL;
+        curl_easy_getinfo(handle, CURLINFO_EFFECTIVE_URL, &url);
+        if (url == NULL) {
+            url = "";
+        }
+        // The query string is left out so the API key does not end up in logs
+        fprintf(stderr, "[http] %ld %s dns=%.1fms connect=%.1fms tls=%.1fms ttfb=%.1fms total=%.1fms %.*s\n",
+                response->status, response->reusedConnection ? "reused" : "new",
+                response->nameLookupTime * 1000, response->connectTime * 1000, response->tlsTime * 1000,
+                response->firstByteTime * 1000, response->totalTime * 1000, (int)strcspn(url, "?"), url);
+    }
+}
@@ -14,19 +14,40 @@
 #include "user_interface.h" // Header file for managing user interface functions
 #include "user_interaction.h" // Header file for user interaction functionalities
 #include "date_utils.h" // Header file containing utility functions for handling dates and times
+#include "catalog_cache.h" // Header file for the on-disk currency catalog cache
+#include "http_client.h" // Header file for the shared HTTP transport layer
+#include "rate_store.h" // Header file for the persistent historical rate store
+#include "batch_conversion.h" // Header file for the non-interactive batch conversion mode
 
 
-int main() {
+int main(int argc, char* argv[]) {
     // Variables to store user inputs and choice
     double amount;
-    char fromCurrency[10], toCurrency[10], date[11];
+    CurrencyId fromCurrency, toCurrency;
+    char date[11];
     char currentDate[11];
     int choice = 0;
 
+    // Set up the shared HTTP transport before any request is made
+    initHttpClient();
+
+    // Load supported currencies from the local cache (or the API on first run)
+    initCurrencyCatalog();
+
+    // Map the store of previously downloaded exchange rates (conversions still work without it)
+    openRateStore(RATE_STORE_FILE);
+
+    // Run without the menu when started as: tconvert --batch [input] [output]
+    if (argc >= 2 && strcmp(argv[1], BATCH_OPTION) == 0) {
+        int status = runBatchConversion(argc >= 3 ? argv[2] : BATCH_STDIO_PATH, argc >= 4 ? argv[3] : BATCH_STDIO_PATH);
+        closeRateStore();
+        return status;
+    }
+
     // Main loop controlling the menu
     while (choice != 3) {
-        // Fetch supported currencies from the API
-        fetchSupportedCurrencies();
+        // Refresh the currency catalog in the background once its TTL has expired
+        refreshCurrencyCatalogIfStale();
 
         // Display initial interface
         displayInitialInterface();
@@ -41,8 +62,8 @@ int main() {
                     printf("\n\t\t\t\t\t\t\t=================================================================\n");
 
                     // Get source and target currencies and validate
-                    validateCurrency(fromCurrency, "source");
-                    validateCurrency(toCurrency, "target");
+                    fromCurrency = validateCurrency("source");
+                    toCurrency = validateCurrency("target");
 
                     // Validate and get the amount to convert
                     amount = validateAmount();
@@ -98,5 +119,8 @@ int main() {
         }
     } // End of while loop
 
+    // Write back any exchange rates downloaded this session
+    closeRateStore();
+
     return 0;
 }
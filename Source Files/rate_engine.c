@@ -0,0 +1,461 @@
+// rate_engine.c - Source file for the local cross-rate engine
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <time.h>       // Library for date and time functions like time, localtime, etc.
+#include <curl/curl.h>  // Library for making HTTP requests and working with URLs using libcurl
+#include "cJSON.h"      // Header for cJSON, a lightweight JSON parsing library
+#include "api_utils.h"  // Header file containing API-related constants, structures, and functions
+#include "currency_catalog.h" // Header file for the currency catalog object
+#include "date_utils.h" // Header file containing utility functions for handling dates and times
+#include "http_client.h" // Header file for the shared HTTP transport layer
+#include "http_async.h" // Header file for the asynchronous request engine
+#include "utilities.h" // Header file for miscellaneous utility functions
+#include "rate_engine.h" // Header file for the local cross-rate engine
+#include "rate_store.h" // Header file for the persistent historical rate store
+
+// Every prefetch transfer must find a pooled handle, with one left over for the background catalog refresh,
+// otherwise each prefetch creates and destroys one-off handles and loses their warm connections
+#if RATE_PREFETCH_CONCURRENCY >= HTTP_POOL_SIZE
+#error "HTTP_POOL_SIZE must be larger than RATE_PREFETCH_CONCURRENCY"
+#endif
+
+
+// Rate vectors of recently used dates; a slot with an empty date is unused
+static RateVector rateCache[RATE_CACHE_SLOTS];
+static int nextEvictedSlot = 0; // Round-robin position used when every slot is taken
+static HttpRequestQueue rateQueue; // Queue carrying rate downloads; the engine is only used from one thread
+
+// Top-level fields of a /latest or /historical response that are read
+typedef enum RateField {
+    RATE_FIELD_NONE,
+    RATE_FIELD_SUCCESS,
+    RATE_FIELD_ERROR,
+    RATE_FIELD_DESCRIPTION,
+    RATE_FIELD_RATES
+} RateField;
+
+
+// State of the event handler reading a /latest or /historical response
+// Rates go straight into 'vector'; the error details are kept until the end, since "success" may come after them
+typedef struct RateReader {
+    const CurrencyCatalog* catalog; // Catalog whose IDs index the rates
+    RateVector* vector;         // Vector receiving the rates
+    int depth;                  // Nesting depth of the current value (1 = the top-level object)
+    RateField pending;          // Field the next value at depth 1 belongs to
+    unsigned seenFields;        // Bit per RateField whose key has been met; later duplicates are ignored
+    bool inRates;               // Whether the container at depth 2 is the "rates" object
+    bool hasRates;              // Whether "rates" was an object
+    bool failed;                // Whether "success" was false
+    CurrencyId rateId;          // Currency whose rate comes next in "rates" (INVALID_CURRENCY_ID if none)
+    char error[128];            // Value of "error" ("unknown" if absent)
+    char description[256];      // Value of "description" ("none" if absent)
+} RateReader;
+
+
+// State of one rate download while it is in flight
+typedef struct RateDownload {
+    char date[11];              // Date being downloaded
+    bool isFinal;               // True if the day has ended, so the rates are final
+    cJSON_StreamParser* parser; // Parser the response is fed to as it arrives
+    RateReader reader;          // Event handler state of the parser
+    RateVector vector;          // Rates read so far
+    int* completed;             // Counter of successful downloads to increment
+    bool* failed;               // Flag to set if the download fails (NULL if nobody asked)
+} RateDownload;
+
+
+// Event handlers for a rate response: every number directly inside the top-level "rates" object is the rate of its key
+// Function to enter an object or array, noting when it is the top-level "rates" object
+static cJSON_bool rateStartContainer(void* context, bool isObject) {
+    RateReader* reader = (RateReader*)context;
+    reader->depth++;
+    if (reader->depth == 2 && reader->pending == RATE_FIELD_RATES && isObject) {
+        reader->inRates = true;
+        reader->hasRates = true;
+    }
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID; // A container is never a rate
+    return true;
+}
+
+// Function to handle the start of an object
+static cJSON_bool rateStartObject(void* context) {
+    return rateStartContainer(context, true);
+}
+
+// Function to handle the start of an array
+static cJSON_bool rateStartArray(void* context) {
+    return rateStartContainer(context, false);
+}
+
+// Function to leave an object or array
+static cJSON_bool rateEndContainer(void* context) {
+    RateReader* reader = (RateReader*)context;
+    if (reader->depth == 2) {
+        reader->inRates = false;
+    }
+    reader->depth--;
+    return true;
+}
+
+// Function to note which currency or top-level field the next value belongs to
+static cJSON_bool rateKey(void* context, const char* key) {
+    RateReader* reader = (RateReader*)context;
+    RateField field = RATE_FIELD_NONE;
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID;
+
+    if (reader->depth == 2 && reader->inRates) {
+        reader->rateId = findCurrencyId(reader->catalog, key); // Codes outside the catalog are ignored
+        return true;
+    }
+    if (reader->depth != 1) {
+        return true;
+    }
+
+    if (strcmp(key, "success") == 0) {
+        field = RATE_FIELD_SUCCESS;
+    } else if (strcmp(key, "error") == 0) {
+        field = RATE_FIELD_ERROR;
+    } else if (strcmp(key, "description") == 0) {
+        field = RATE_FIELD_DESCRIPTION;
+    } else if (strcmp(key, "rates") == 0) {
+        field = RATE_FIELD_RATES;
+    }
+
+    // Only the first occurrence of a key counts, whatever its value
+    if (field != RATE_FIELD_NONE && !(reader->seenFields & (1u << field))) {
+        reader->seenFields |= 1u << field;
+        reader->pending = field;
+    }
+    return true;
+}
+
+// Function to keep the error code and description of a failed response
+static cJSON_bool rateString(void* context, const char* value) {
+    RateReader* reader = (RateReader*)context;
+    if (reader->pending == RATE_FIELD_ERROR) {
+        snprintf(reader->error, sizeof(reader->error), "%s", value);
+    } else if (reader->pending == RATE_FIELD_DESCRIPTION) {
+        snprintf(reader->description, sizeof(reader->description), "%s", value);
+    }
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID;
+    return true;
+}
+
+// Function to store the rate of a catalog currency
+static cJSON_bool rateNumber(void* context, double value) {
+    RateReader* reader = (RateReader*)context;
+    if (reader->rateId != INVALID_CURRENCY_ID && value > 0) {
+        reader->vector->rates[reader->rateId] = value;
+    }
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID;
+    return true;
+}
+
+// Function to record a "success": false response
+static cJSON_bool rateBoolean(void* context, cJSON_bool value) {
+    RateReader* reader = (RateReader*)context;
+    if (reader->pending == RATE_FIELD_SUCCESS && !value) {
+        reader->failed = true;
+    }
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID;
+    return true;
+}
+
+// Function to skip a null value
+static cJSON_bool rateNull(void* context) {
+    RateReader* reader = (RateReader*)context;
+    reader->pending = RATE_FIELD_NONE;
+    reader->rateId = INVALID_CURRENCY_ID;
+    return true;
+}
+
+static const cJSON_SAXHandler rateHandler = {
+    rateStartObject, rateEndContainer, rateStartArray, rateEndContainer,
+    rateKey, rateString, rateNumber, rateBoolean, rateNull
+};
+
+
+// Function to check a fully read /latest or /historical response and complete its rate vector
+// Prints the API's error details and returns false when the response reports a failure;
+// the caller that wanted the rates prints the summary line
+static bool finishRateVector(const RateReader* reader) {
+    if (reader->failed) {
+        fprintf(stderr, "\n\t\t\t\t\t\t\tError Result:");
+        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
+        fprintf(stderr, "\n\t\t\t\t\t\t\tError: %s\n", reader->error);
+        fprintf(stderr, "\n\t\t\t\t\t\t\tDescription: %s", reader->description);
+        fprintf(stderr, "\n\t\t\t\t\t\t\t--------------------------------------------------");
+        return false;
+    }
+    if (!reader->hasRates) {
+        return false;
+    }
+
+    // The base currency is implied by the response even if it is not listed
+    CurrencyId base = findCurrencyId(reader->catalog, RATE_BASE_CURRENCY);
+    if (base != INVALID_CURRENCY_ID) {
+        reader->vector->rates[base] = 1.0;
+    }
+    return true;
+}
+
+
+// Function to check whether a cached vector can still be used
+// Final rates never change; rates fetched during their own day expire after the TTL and once the day ends
+static bool isRateVectorFresh(const RateVector* vector, const CurrencyCatalog* catalog) {
+    char currentDate[11];
+
+    if (vector->catalogGeneration != catalog->generation) {
+        return false; // Built against another catalog, so its IDs no longer line up
+    }
+    if (vector->isFinal) {
+        return true;
+    }
+
+    getCurrentDateUTC(currentDate);
+    if (strcmp(vector->date, currentDate) < 0) {
+        return false; // Provisional rates of a day that has since ended
+    }
+    return time(NULL) - vector->fetchedAt < getEnvSeconds(RATES_TTL_ENV, RATES_TTL_SECONDS);
+}
+
+
+// Function to find the in-memory vector of a date (NULL if the date is not cached)
+static RateVector* findCachedRateVector(const char* date) {
+    for (int i = 0; i < RATE_CACHE_SLOTS; ++i) {
+        if (strcmp(rateCache[i].date, date) == 0) {
+            return &rateCache[i];
+        }
+    }
+    return NULL;
+}
+
+
+// Function to pick the slot a vector of 'date' is written to
+// Reuses the slot already holding this date, else takes an empty one, else evicts round-robin
+static RateVector* takeRateSlot(const char* date) {
+    RateVector* slot = findCachedRateVector(date);
+
+    for (int i = 0; slot == NULL && i < RATE_CACHE_SLOTS; ++i) {
+        if (rateCache[i].date[0] == '\0') {
+            slot = &rateCache[i];
+        }
+    }
+    if (slot == NULL) {
+        slot = &rateCache[nextEvictedSlot];
+        nextEvictedSlot = (nextEvictedSlot + 1) % RATE_CACHE_SLOTS;
+    }
+    return slot;
+}
+
+
+// Function to find fresh rates of a date without going to the network
+// Checks the in-memory cache, then the rate store (caching what it finds there)
+static RateVector* findFreshRateVector(const char* date, const CurrencyCatalog* catalog) {
+    RateVector* cached = findCachedRateVector(date);
+    if (cached != NULL && isRateVectorFresh(cached, catalog)) {
+        return cached;
+    }
+
+    // Load into a scratch vector so a stale row does not replace the slot's contents
+    RateVector stored;
+    if (loadStoredRates(date, &stored) && isRateVectorFresh(&stored, catalog)) {
+        RateVector* slot = takeRateSlot(date);
+        *slot = stored;
+        return slot;
+    }
+    return NULL;
+}
+
+
+// Function to check whether a date has to be downloaded
+// Same outcome as findFreshRateVector() but only reads the store's row metadata, so it is cheap to call per date
+static bool needsRateDownload(const char* date, const CurrencyCatalog* catalog) {
+    RateVector* cached = findCachedRateVector(date);
+    if (cached != NULL && isRateVectorFresh(cached, catalog)) {
+        return false;
+    }
+
+    // Store rows are keyed by currency code, so they are valid for any catalog generation
+    RateVector stored;
+    strcpy(stored.date, date);
+    stored.catalogGeneration = catalog->generation;
+    return !findStoredRates(date, &stored.fetchedAt, &stored.isFinal) || !isRateVectorFresh(&stored, catalog);
+}
+
+
+// Function to handle a finished rate download
+// The response has already been parsed while it arrived; caches and stores the vector it filled.
+// Runs on the thread polling the rate queue
+static void completeRateDownload(CURL* handle, CURLcode result, const HttpResponse* response, void* userData) {
+    RateDownload* download = userData;
+    bool success = false;
+
+    (void)handle;
+    (void)response;
+
+    if (result != CURLE_OK) {
+        fprintf(stderr, "\n\t\t\t\t\t\t\tFailed to fetch exchange rates: %s\n\n", curl_easy_strerror(result));
+    } else {
+        bool parsed = cJSON_FinishStreamParser(download->parser);
+        success = parsed && finishRateVector(&download->reader);
+        // An error reported by the API has already been printed by finishRateVector
+        if (!success && !(parsed && download->reader.failed)) {
+            fprintf(stderr, "\n\t\t\t\t\t\t\tFailed to parse exchange rate data from API response.\n");
+        }
+    }
+
+    if (success) {
+        RateVector* vector = &download->vector;
+        strcpy(vector->date, download->date);
+        vector->fetchedAt = time(NULL);
+        vector->catalogGeneration = download->reader.catalog->generation;
+        vector->isFinal = download->isFinal;
+
+        *takeRateSlot(download->date) = *vector;
+        storeRates(vector); // Keep the rates for later sessions
+        (*download->completed)++;
+    } else if (download->failed != NULL) {
+        *download->failed = true;
+    }
+
+    cJSON_DeleteStreamParser(download->parser);
+    free(download);
+}
+
+
+// Function to start the download of one date on the rate queue
+// The current UTC date is served by /latest, earlier dates by /historical.
+// The response is parsed as it arrives, straight into a rate vector indexed by 'catalog'
+static bool submitRateDownload(const char* date, const char* currentDate, const CurrencyCatalog* catalog, int* completed, bool* failed) {
+    char url[512];
+
+    RateDownload* download = malloc(sizeof(RateDownload));
+    if (download == NULL) {
+        return false;
+    }
+    memset(download, 0, sizeof(RateDownload));
+    strcpy(download->date, date);
+    download->isFinal = strcmp(date, currentDate) < 0; // Rates of a day that has ended are immutable
+    download->completed = completed;
+    download->failed = failed;
+    download->reader.catalog = catalog;
+    download->reader.vector = &download->vector;
+    download->reader.rateId = INVALID_CURRENCY_ID;
+    strcpy(download->reader.error, "unknown");
+    strcpy(download->reader.description, "none");
+    download->parser = cJSON_CreateStreamParser(&rateHandler, &download->reader);
+
+    if (download->isFinal) {
+        snprintf(url, sizeof(url), URL_HISTORICAL, getApiBaseUrl(), date, RATE_BASE_CURRENCY, API_KEY);
+    } else {
+        snprintf(url, sizeof(url), URL_LATEST, getApiBaseUrl(), RATE_BASE_CURRENCY, API_KEY);
+    }
+
+    CURL* curl = acquireHttpHandle(); // Borrow a warm CURL handle from the pool
+    if (curl == NULL || download->parser == NULL) {
+        releaseHttpHandle(curl);
+        cJSON_DeleteStreamParser(download->parser);
+        free(download);
+        return false;
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, url);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallbackForStream);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)download->parser);
+
+    // On failure the queue has already released the handle
+    if (!submitHttpRequest(&rateQueue, curl, completeRateDownload, download)) {
+        cJSON_DeleteStreamParser(download->parser);
+        free(download);
+        return false;
+    }
+    return true;
+}
+
+
+// Function to make sure the rates of several dates are available
+// Dates without fresh rates in memory or in the store are downloaded concurrently, at most
+// RATE_PREFETCH_CONCURRENCY at a time, and multiplexed over one connection when the API speaks HTTP/2
+// When 'failed' is not NULL, failed[i] is set for each date that is malformed or could not be downloaded
+// Returns the number of dates that had to be downloaded and were downloaded successfully
+int prefetchRateVectors(const char* const dates[], int count, bool failed[]) {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    char currentDate[11];
+    int completed = 0;
+    int next = 0;
+
+    if (catalog == NULL || (rateQueue.multi == NULL && !initHttpRequestQueue(&rateQueue))) {
+        for (int i = 0; failed != NULL && i < count; ++i) {
+            failed[i] = true;
+        }
+        return 0;
+    }
+    if (failed != NULL) {
+        memset(failed, 0, count * sizeof(bool));
+    }
+
+    getCurrentDateUTC(currentDate);
+    while (next < count || rateQueue.inFlight > 0) {
+        // Keep the queue topped up with the dates that still need a download
+        while (next < count && rateQueue.inFlight < RATE_PREFETCH_CONCURRENCY) {
+            bool* dateFailed = failed != NULL ? &failed[next] : NULL;
+            const char* date = dates[next++];
+            bool started = validateDateFormat(date)
+                && (!needsRateDownload(date, catalog) || submitRateDownload(date, currentDate, catalog, &completed, dateFailed));
+            if (!started && dateFailed != NULL) {
+                *dateFailed = true; // A download that does start reports its own failure
+            }
+        }
+        pollHttpRequests(&rateQueue, HTTP_ASYNC_POLL_TIMEOUT_MS);
+    }
+    return completed;
+}
+
+
+// Function to get the rate vector of a date
+// Looks the date up in the in-memory cache, then in the rate store, and downloads it only when neither has fresh rates
+// Returns NULL if no catalog is loaded or the download fails
+const RateVector* getRateVector(const char* date) {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+
+    if (catalog == NULL || !validateDateFormat(date)) {
+        return NULL;
+    }
+
+    RateVector* vector = findFreshRateVector(date, catalog);
+    if (vector == NULL && prefetchRateVectors(&date, 1, NULL) == 1) {
+        vector = findCachedRateVector(date); // Just filled in by the download
+    }
+    return vector;
+}
+
+
+// Function to compute a cross rate locally
+// Any pair is derived from the base-currency vector as rates[to] / rates[from]
+// Each rate is rounded by the API to d significant digits (at most 0.5e(1-d) relative error), so the quotient differs
+// from the API's own cross rate of the same snapshot by at most 1e(1-d) plus one double rounding, e.g. 1e-9 for
+// 10-digit rates. A /convert answer can differ further by its own rounding and by coming from a newer snapshot.
+// Returns false if the rates are unavailable or either currency has no rate on that date
+bool getCrossRate(CurrencyId fromId, CurrencyId toId, const char* date, double* rate) {
+    const RateVector* vector = getRateVector(date);
+    if (vector == NULL || fromId >= MAX_CURRENCIES || toId >= MAX_CURRENCIES) {
+        return false;
+    }
+
+    double fromRate = vector->rates[fromId];
+    double toRate = vector->rates[toId];
+    if (fromRate <= 0 || toRate <= 0) {
+        return false;
+    }
+
+    *rate = toRate / fromRate;
+    return true;
+}
@@ -0,0 +1,308 @@
+// rate_store.c - Source file for the persistent historical rate store
+
+#include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
+#include <stdbool.h>    // Library for using boolean data type with true and false values
+#include <stdint.h>     // Library providing fixed-width integer types like uint32_t
+#include <string.h>     // Library for string manipulation functions like strlen, strcpy, etc.
+#include <time.h>       // Library for date and time functions like time, localtime, etc.
+#include <winsock2.h>  // Header providing Winsock 2 API declarations for network programming on Windows
+#include <windows.h>    // Library providing functions for Windows API and system-related functions
+#include "currency_catalog.h" // Header file for the currency catalog object
+#include "date_utils.h" // Header file containing utility functions for handling dates and times
+#include "rate_engine.h" // Header file for the local cross-rate engine
+#include "rate_store.h" // Header file for the persistent historical rate store
+
+
+// Layout of the store file, mapped into memory as-is so only the pages actually touched are read:
+//   RateStoreHeader   magic, version, the currency code of each column and a row index per day
+//   RateStoreRow[]    one row per stored day, in the order the days were first downloaded
+// Columns are keyed by currency code rather than catalog ID, so rows stay valid when the catalog changes.
+// A row is published by writing its index entry last, after the row itself has been filled in.
+typedef struct RateStoreHeader {
+    char magic[4];          // Signature "TCVR"
+    uint32_t version;       // Layout version
+    uint32_t columnCount;   // Number of columns in use
+    uint32_t rowCount;      // Number of rows in use
+    char columns[RATE_STORE_COLUMNS][CURRENCY_CODE_SIZE]; // Currency code of each column
+    uint32_t dayIndex[RATE_STORE_MAX_DAYS]; // Row + 1 of each day since 1970-01-01, 0 when the day is not stored
+} RateStoreHeader;
+
+typedef struct RateStoreRow {
+    int64_t fetchedAt;      // Time at which the rates were downloaded
+    uint32_t isFinal;       // Non-zero when the rates were downloaded after the day ended
+    uint32_t reserved;      // Keeps the rates 8-byte aligned
+    double rates[RATE_STORE_COLUMNS]; // Rate per column against the base currency, 0 when unknown
+} RateStoreRow;
+
+#define NO_STORE_COLUMN 0xFFFF // Marks a catalog currency that has no column yet
+
+
+// State of the mapped store
+static HANDLE storeFile = INVALID_HANDLE_VALUE; // Open store file
+static HANDLE storeMapping = NULL; // File mapping object backing the view
+static RateStoreHeader* store = NULL; // Mapped view of the whole file (NULL when the store is unavailable)
+static unsigned long long storeSize = 0; // Size of the mapped view in bytes
+
+// Column of each currency ID in the active catalog, rebuilt when the catalog generation changes
+static uint16_t columnOfId[MAX_CURRENCIES];
+static unsigned long mappedGeneration = 0;
+
+
+// Function to release the current view and mapping of the store file
+static void unmapRateStore() {
+    if (store != NULL) {
+        UnmapViewOfFile(store);
+        store = NULL;
+    }
+    if (storeMapping != NULL) {
+        CloseHandle(storeMapping);
+        storeMapping = NULL;
+    }
+    storeSize = 0;
+}
+
+
+// Function to map 'size' bytes of the store file, growing the file if it is shorter
+static bool mapRateStore(unsigned long long size) {
+    unmapRateStore();
+
+    storeMapping = CreateFileMappingA(storeFile, NULL, PAGE_READWRITE, (DWORD)(size >> 32), (DWORD)(size & 0xFFFFFFFF), NULL);
+    if (storeMapping == NULL) {
+        return false;
+    }
+
+    store = MapViewOfFile(storeMapping, FILE_MAP_WRITE, 0, 0, 0);
+    if (store == NULL) {
+        CloseHandle(storeMapping);
+        storeMapping = NULL;
+        return false;
+    }
+
+    storeSize = size;
+    return true;
+}
+
+
+// Function to get the number of rows the mapped file has room for
+static uint32_t getRowCapacity() {
+    return (uint32_t)((storeSize - sizeof(RateStoreHeader)) / sizeof(RateStoreRow));
+}
+
+
+// Function to get a row of the mapped store by position
+static RateStoreRow* getStoreRow(uint32_t row) {
+    return (RateStoreRow*)((char*)store + sizeof(RateStoreHeader)) + row;
+}
+
+
+// Function to get the index slot of a date
+// Returns -1 for malformed dates, dates that do not exist and dates outside the indexed range
+static long getStoreDay(const char* date) {
+    char canonical[11];
+
+    if (!validateDateFormat(date)) {
+        return -1;
+    }
+    long day = getDayNumber(date);
+
+    // getDayNumber() rolls an impossible date such as 2023-02-30 over into a real one
+    formatDayNumber(day, canonical);
+    if (strcmp(canonical, date) != 0) {
+        return -1;
+    }
+    return (day >= 0 && day < RATE_STORE_MAX_DAYS) ? day : -1;
+}
+
+
+// Function to get the stored row of a day (NULL if the day is not stored)
+static RateStoreRow* findStoredRow(long day) {
+    uint32_t entry = store->dayIndex[day];
+    if (entry == 0 || entry > store->rowCount) {
+        return NULL;
+    }
+    return getStoreRow(entry - 1);
+}
+
+
+// Function to map the currency IDs of the active catalog onto store columns
+static void updateColumnMap(const CurrencyCatalog* catalog) {
+    if (mappedGeneration == catalog->generation) {
+        return;
+    }
+
+    for (int id = 0; id < MAX_CURRENCIES; ++id) {
+        columnOfId[id] = NO_STORE_COLUMN;
+    }
+    for (uint32_t column = 0; column < store->columnCount; ++column) {
+        CurrencyId id = findCurrencyId(catalog, store->columns[column]);
+        if (id != INVALID_CURRENCY_ID && id < MAX_CURRENCIES) {
+            columnOfId[id] = (uint16_t)column;
+        }
+    }
+    mappedGeneration = catalog->generation;
+}
+
+
+// Function to open the rate store
+// Maps the existing file, or starts an empty store when the file is new, truncated or from another version
+bool openRateStore(const char* path) {
+    LARGE_INTEGER fileSize;
+
+    if (store != NULL) {
+        return true; // Already open
+    }
+
+    storeFile = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (storeFile == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    if (!GetFileSizeEx(storeFile, &fileSize)) {
+        closeRateStore();
+        return false;
+    }
+
+    bool valid = (unsigned long long)fileSize.QuadPart >= sizeof(RateStoreHeader)
+        && mapRateStore((unsigned long long)fileSize.QuadPart)
+        && memcmp(store->magic, RATE_STORE_MAGIC, 4) == 0
+        && store->version == RATE_STORE_VERSION
+        && store->columnCount <= RATE_STORE_COLUMNS
+        && store->rowCount <= getRowCapacity();
+
+    if (!valid) {
+        LARGE_INTEGER start;
+        start.QuadPart = 0;
+
+        // Truncate and map a fresh, zero-filled file
+        unmapRateStore();
+        if (!SetFilePointerEx(storeFile, start, NULL, FILE_BEGIN) || !SetEndOfFile(storeFile)
+            || !mapRateStore(sizeof(RateStoreHeader) + RATE_STORE_GROWTH_ROWS * sizeof(RateStoreRow))) {
+            closeRateStore();
+            return false;
+        }
+        memcpy(store->magic, RATE_STORE_MAGIC, 4);
+        store->version = RATE_STORE_VERSION;
+    }
+
+    mappedGeneration = 0; // Columns must be mapped against the catalog again
+    return true;
+}
+
+
+// Function to close the rate store
+void closeRateStore() {
+    if (store != NULL) {
+        FlushViewOfFile(store, 0);
+    }
+    unmapRateStore();
+    if (storeFile != INVALID_HANDLE_VALUE) {
+        CloseHandle(storeFile);
+        storeFile = INVALID_HANDLE_VALUE;
+    }
+}
+
+
+// Function to read the stored rates of a date
+// The row is translated from store columns to the IDs of the active catalog
+bool loadStoredRates(const char* date, RateVector* vector) {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    long day = getStoreDay(date);
+
+    if (store == NULL || catalog == NULL || day < 0) {
+        return false;
+    }
+
+    const RateStoreRow* row = findStoredRow(day);
+    if (row == NULL) {
+        return false;
+    }
+
+    updateColumnMap(catalog);
+    memset(vector->rates, 0, sizeof(vector->rates));
+    for (int id = 0; id < catalog->count && id < MAX_CURRENCIES; ++id) {
+        if (columnOfId[id] != NO_STORE_COLUMN) {
+            vector->rates[id] = row->rates[columnOfId[id]];
+        }
+    }
+
+    strcpy(vector->date, date);
+    vector->fetchedAt = (time_t)row->fetchedAt;
+    vector->catalogGeneration = catalog->generation;
+    vector->isFinal = row->isFinal != 0;
+    return true;
+}
+
+
+// Function to look up a date in the store without translating its rates
+bool findStoredRates(const char* date, time_t* fetchedAt, bool* isFinal) {
+    long day = getStoreDay(date);
+    if (store == NULL || day < 0) {
+        return false;
+    }
+
+    const RateStoreRow* row = findStoredRow(day);
+    if (row == NULL) {
+        return false;
+    }
+    *fetchedAt = (time_t)row->fetchedAt;
+    *isFinal = row->isFinal != 0;
+    return true;
+}
+
+
+// Function to write the rates of a date to the store
+// A final row is never rewritten; a provisional one (downloaded while its day was still running) is replaced
+bool storeRates(const RateVector* vector) {
+    const CurrencyCatalog* catalog = getActiveCatalog();
+    long day = getStoreDay(vector->date);
+
+    if (store == NULL || catalog == NULL || day < 0 || vector->catalogGeneration != catalog->generation) {
+        return false;
+    }
+
+    const RateStoreRow* stored = findStoredRow(day);
+    if (stored != NULL && stored->isFinal) {
+        return true; // Past days never change
+    }
+
+    // Fill a fresh row past the end, growing the file when it is full, so readers never see a half-written row
+    uint32_t previous = stored != NULL ? store->dayIndex[day] : 0;
+    if (store->rowCount == getRowCapacity()
+        && !mapRateStore(storeSize + RATE_STORE_GROWTH_ROWS * sizeof(RateStoreRow))) {
+        return false;
+    }
+    uint32_t entry = store->rowCount + 1;
+    RateStoreRow* row = getStoreRow(entry - 1);
+
+    updateColumnMap(catalog);
+    memset(row->rates, 0, sizeof(row->rates));
+    for (int id = 0; id < catalog->count && id < MAX_CURRENCIES; ++id) {
+        if (vector->rates[id] <= 0) {
+            continue;
+        }
+
+        // Give currencies the store has not seen before a column of their own
+        if (columnOfId[id] == NO_STORE_COLUMN && store->columnCount < RATE_STORE_COLUMNS) {
+            memcpy(store->columns[store->columnCount], getCurrencyCode(catalog, (CurrencyId)id), CURRENCY_CODE_SIZE);
+            columnOfId[id] = (uint16_t)store->columnCount++;
+        }
+        if (columnOfId[id] != NO_STORE_COLUMN) {
+            row->rates[columnOfId[id]] = vector->rates[id];
+        }
+    }
+    row->fetchedAt = (int64_t)vector->fetchedAt;
+    row->isFinal = vector->isFinal;
+
+    // Publish the row only once it is complete
+    store->rowCount = entry;
+    store->dayIndex[day] = entry;
+
+    // A replaced provisional row that was the last one is reclaimed: it is no longer referenced,
+    // so it can take a copy of the new row and be published again without the file growing on every refresh
+    if (previous != 0 && previous == entry - 1) {
+        memcpy(getStoreRow(previous - 1), row, sizeof(RateStoreRow));
+        store->dayIndex[day] = previous;
+        store->rowCount = previous;
+    }
+    return true;
+}
@@ -1,6 +1,7 @@
 // utilities.c - Source file for utility functions
 
 #include <stdio.h>      // Standard input-output library for basic I/O functions like printf and scanf
+#include <stdlib.h>     // Standard library providing functions for memory allocation, random numbers, etc.
 #include "utilities.h" // Header file for miscellaneous utility functions
 
 
@@ -17,3 +18,18 @@ void clearInputBuffer() {
         clearerr(stdin);
     }
 }
+
+
+// Function to read a duration from the environment
+// Returns the value of 'name' when it holds a non-negative whole number of seconds, otherwise 'defaultSeconds'
+long getEnvSeconds(const char* name, long defaultSeconds) {
+    const char* value = getenv(name);
+    if (value != NULL && *value != '\0') {
+        char* end;
+        long seconds = strtol(value, &end, 10);
+        if (*end == '\0' && seconds >= 0) {
+            return seconds;
+        }
+    }
+    return defaultSeconds;
+}